@@ -0,0 +1,57 @@
+/*****************************************************************************
+File:   AllocationCounter.cpp
+Author: Alex Troyer
+  Counts every allocation made through the global new so tests can check
+  that something doesn't allocate.
+*****************************************************************************/
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> s_AllocationCount(0);
+
+// Replace the global new and delete.  The array and sized versions all have to be
+// replaced too so everything goes through malloc and free.
+void *operator new(size_t size)
+{
+  s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+  void *ptr = std::malloc(size ? size : 1);
+
+  if(ptr == nullptr)
+    throw std::bad_alloc();
+
+  return ptr;
+}
+
+void *operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+// Get how many times the global new has been called so far.
+size_t GetAllocationCount()
+{
+  return s_AllocationCount.load(std::memory_order_relaxed);
+}
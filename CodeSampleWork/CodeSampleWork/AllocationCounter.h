@@ -0,0 +1,12 @@
+/*****************************************************************************
+File:   AllocationCounter.h
+Author: Alex Troyer
+  Counts every allocation made through the global new so tests can check
+  that something doesn't allocate.
+*****************************************************************************/
+#pragma once
+
+#include <cstddef>
+
+// Get how many times the global new has been called so far.
+size_t GetAllocationCount();
@@ -5,78 +5,114 @@ Author: Alex Troyer
 *****************************************************************************/
 #include "Any.h"
 #include "Meta.h"
+#include "Hash.h"
+#include "Diff.h"
 
 // Default constructs a type based off of the meta data given.
 Any::Any(Meta::Data *metaData)
-  : m_MetaData(metaData)
+  : Any(metaData, nullptr)
 {
-  m_Data = m_MetaData->GetObjectInfo()->Construct();
+}
 
-  // It is possible for a class to not have a default constructor
-  FATAL_ERROR_IF(m_Data == nullptr, metaData->GetName() + " doesn't have a default constructor!");
+// Make an empty Any that gets the memory for any data it has to allocate from the
+// given resource.  The resource has to outlive the data.
+Any::Any(Meta::MemoryResource *resource)
+  : m_Resource(resource)
+  , m_IsResourceGiven(resource != nullptr)
+{
 }
 
-// Copy constructor for Any.
-Any::Any(const Any &any)
-  : m_MetaData(any.m_MetaData)
+// Default constructs a type based off of the meta data given.  If it doesn't fit in
+// the Any, it is allocated from the given resource.
+Any::Any(Meta::Data *metaData, Meta::MemoryResource *resource)
+  : m_MetaData(metaData)
+  , m_Resource(resource)
+  , m_IsInline(StoresInline(metaData))
+  , m_IsResourceGiven(resource != nullptr)
 {
-  if(m_MetaData)
+  const Meta::LifetimeTable &lifetime = m_MetaData->GetLifetime();
+
+  if(m_IsInline)
   {
-    m_Data = m_MetaData->GetObjectInfo()->Copy(any.GetInternal());
+    // It is possible for a class to not have a default constructor
+    FATAL_ERROR_IF(lifetime.m_Construct == nullptr, metaData->GetName() + " doesn't have a default constructor!");
 
-    FATAL_ERROR_IF(m_Data == nullptr, m_MetaData->GetName() + " doesn't have a copy constructor!");
+    m_Data = &m_Buffer;
+    lifetime.m_Construct(m_Data);
+  }
+  else
+  {
+    m_Data = lifetime.ConstructIn(GetAllocationResource());
+
+    // It is possible for a class to not have a default constructor
+    FATAL_ERROR_IF(m_Data == nullptr, metaData->GetName() + " doesn't have a default constructor!");
   }
 }
 
+// Copy constructor for Any.
+Any::Any(const Any &any)
+{
+  CopyFrom(any);
+}
+
 // Move constructor for Any.
-// Take all the data from the other Any and put it in this one.
+// Take all the data from the other Any and put it in this one, along with where its 
+// memory comes from.
 Any::Any(Any &&any)
-  : m_MetaData(any.m_MetaData)
-  , m_Data(any.m_Data)
-  , m_HoldsReference(any.m_HoldsReference)
+  : m_Resource(any.m_Resource)
+  , m_IsResourceGiven(any.m_IsResourceGiven)
+{
+  MoveFrom(any);
+}
+
+// Create a reference to an object whose type is only known through its meta data.
+// The object is not owned by the Any.
+Any Any::AnyRef(void *data, Meta::Data *metaData)
+{
+  Any any;
+  any.m_HoldsReference = true;
+  any.m_MetaData = metaData;
+  any.m_Data = data;
+  return any;
+}
+
+// Create a reference to a const object whose type is only known through its meta data.
+// The object can't be assigned to through the Any.
+Any Any::AnyRef(const void *data, Meta::Data *metaData)
 {
-  any.m_MetaData = nullptr;
-  any.m_Data = nullptr;
-  any.m_HoldsReference = false;
+  Any any = AnyRef(const_cast<void *>(data), metaData);
+  any.m_IsConst = true;
+  return any;
 }
 
 // Destroys any data that the Any created.
-// Will not destroy the given data if it is holding a reference or if the data
-// is const.
+// Will not destroy the given data if it is holding a reference.
 Any::~Any()
 {
-  if(!m_HoldsReference && m_MetaData && !m_IsConst)
-  {
-    m_MetaData->GetObjectInfo()->Destroy(m_Data);
-  }
+  Release();
 }
 
 // Assignment operator from another Any.  Will copy the data from the other any.
 Any &Any::operator=(const Any &rhs)
 {
-  m_HoldsReference = false;
-
-  m_MetaData = rhs.m_MetaData;
-  m_Data = m_MetaData->GetObjectInfo()->Copy(rhs.m_Data);
-  m_HoldsReference = false;
-
-  FATAL_ERROR_IF(m_Data == nullptr, m_MetaData->GetName() + " doesn't have a copy constructor!");
+  if(this != &rhs)
+  {
+    Release();
+    CopyFrom(rhs);
+  }
 
   return *this;
 }
 
 // Move assignment operator from another Any.  Takes the data from the other Any without
-// copy.
+// copy, unless this Any gets its memory from a different resource.
 Any &Any::operator=(Any &&rhs)
 {
-  m_MetaData = rhs.m_MetaData;
-  rhs.m_MetaData = nullptr;
-
-  m_Data = rhs.m_Data;
-  rhs.m_Data = nullptr;
-
-  m_HoldsReference = rhs.m_HoldsReference;
-  rhs.m_HoldsReference = false;
+  if(this != &rhs)
+  {
+    Release();
+    MoveFrom(rhs);
+  }
 
   return *this;
 }
@@ -87,6 +123,41 @@ void *Any::GetInternal() const
   return m_Data;
 }
 
+// Hash the object held with its type's std::hash, or from its properties if it doesn't
+// have one.  An empty Any hashes to 0.
+size_t Any::Hash() const
+{
+  if(m_MetaData == nullptr)
+    return 0;
+
+  return Meta::HashValue(m_MetaData, m_Data);
+}
+
+// Two Anys are equal if they hold the same type and the objects are equal.  This uses
+// the type's == if it has one, otherwise every property has to be the same.  Two empty
+// Anys are equal.
+bool Any::operator==(const Any &rhs) const
+{
+  if(m_MetaData != rhs.m_MetaData)
+    return false;
+
+  if(m_MetaData == nullptr)
+    return true;
+
+  Meta::LifetimeTable::EqualFn equal = m_MetaData->GetLifetime().m_Equal;
+
+  if(equal != nullptr)
+    return equal(m_Data, rhs.m_Data);
+
+  return Meta::Diff(m_MetaData, m_Data, rhs.m_Data).IsEmpty();
+}
+
+// Whether or not the Anys hold different types or objects that aren't equal.
+bool Any::operator!=(const Any &rhs) const
+{
+  return !(*this == rhs);
+}
+
 // Get the Meta data information for the type in this Any.
 Meta::Data *Any::GetMeta() const
 {
@@ -102,5 +173,164 @@ bool Any::IsConst() const
 // See if the Any is holding a reference.
 bool Any::HoldsReference() const
 {
-  return m_IsConst;
+  return m_HoldsReference;
+}
+
+// See if the data is kept inside of the Any instead of on the heap.
+bool Any::IsInline() const
+{
+  return m_IsInline;
+}
+
+// See if objects of the given type will be kept inside of the Any.
+bool Any::StoresInline(Meta::Data *metaData)
+{
+  const Meta::LifetimeTable &lifetime = metaData->GetLifetime();
+
+  return lifetime.m_Size <= BufferSize && 
+         lifetime.m_Alignment <= BufferAlignment && 
+         lifetime.Has(Meta::LifetimeTable::HasNothrowMoveConstructor);
+}
+
+// Copy the data from another Any.  This always makes a copy that the Any owns, even
+// if the other Any holds a reference.  Anything that was in the Any must already
+// be released.
+void Any::CopyFrom(const Any &rhs)
+{
+  m_MetaData = rhs.m_MetaData;
+
+  if(m_MetaData == nullptr)
+    return;
+
+  const Meta::LifetimeTable &lifetime = m_MetaData->GetLifetime();
+
+  // The same type always ends up in the same place, so only a reference has to look.
+  m_IsInline = rhs.m_HoldsReference ? StoresInline(m_MetaData) : rhs.m_IsInline;
+
+  if(m_IsInline)
+  {
+    FATAL_ERROR_IF(lifetime.m_Copy == nullptr, m_MetaData->GetName() + " doesn't have a copy constructor!");
+
+    m_Data = &m_Buffer;
+    lifetime.m_Copy(m_Data, rhs.m_Data);
+  }
+  else
+  {
+    m_Data = lifetime.CopyIn(GetAllocationResource(), rhs.m_Data);
+
+    FATAL_ERROR_IF(m_Data == nullptr, m_MetaData->GetName() + " doesn't have a copy constructor!");
+  }
+}
+
+// Take the data from another Any.  Heap data and references just change hands, but 
+// data in the buffer has to be moved over.  If this Any gets its memory from a 
+// different resource than the heap data came from, the data is moved (or copied) into
+// this Any's resource instead.  The other Any is left empty.  Anything that was in the
+// Any must already be released.
+void Any::MoveFrom(Any &rhs)
+{
+  const Meta::LifetimeTable *lifetime = rhs.m_MetaData != nullptr ? &rhs.m_MetaData->GetLifetime() : nullptr;
+
+  bool ownsHeapData = lifetime != nullptr && !rhs.m_HoldsReference && !rhs.m_IsInline;
+  bool changesResource = ownsHeapData && m_Resource != nullptr && m_Resource != rhs.m_Resource;
+  bool canMoveOver = lifetime != nullptr && (lifetime->m_Move != nullptr || lifetime->m_Copy != nullptr);
+
+  // Taking data that can't be moved or copied into the resource this Any was given 
+  // would leave it holding onto the other resource for good, so it stays where it is.
+  FATAL_ERROR_IF(changesResource && !canMoveOver && m_IsResourceGiven, 
+                 rhs.m_MetaData->GetName() + " can't be moved or copied into the Any's resource!");
+
+  if(changesResource && !canMoveOver && m_IsResourceGiven)
+    return;
+
+  m_MetaData = rhs.m_MetaData;
+  m_HoldsReference = rhs.m_HoldsReference;
+  m_IsConst = rhs.m_IsConst;
+  m_IsInline = rhs.m_IsInline;
+
+  if(m_IsInline)
+  {
+    // Plain data is just copied over and nothing is left to destroy in rhs.
+    m_Data = &m_Buffer;
+    lifetime->m_Relocate(m_Data, rhs.m_Data, 1);
+  }
+  else if(changesResource && canMoveOver)
+  {
+    // Types that can't be moved are copied over instead.
+    if(lifetime->m_Move != nullptr)
+      m_Data = lifetime->MoveConstructIn(m_Resource, rhs.m_Data);
+    else
+      m_Data = lifetime->CopyIn(m_Resource, rhs.m_Data);
+
+    lifetime->DestroyIn(rhs.m_Resource, rhs.m_Data);
+  }
+  else
+  {
+    m_Data = rhs.m_Data;
+
+    // The data has to go back to where it came from.  This is never a resource the
+    // Any was given, so Release forgets it along with the data.
+    if(ownsHeapData)
+      m_Resource = rhs.m_Resource;
+  }
+
+  rhs.m_Data = nullptr;
+  rhs.m_MetaData = nullptr;
+  rhs.m_HoldsReference = false;
+  rhs.m_IsConst = false;
+  rhs.m_IsInline = false;
+
+  // A resource from a scope went with the data.
+  if(!rhs.m_IsResourceGiven)
+    rhs.m_Resource = nullptr;
+}
+
+// Destroy the data if the Any owns it and leave the Any empty.  Data in the buffer
+// only needs its destructor called, everything else was allocated.  The Any keeps 
+// using a resource it was given, but forgets one picked up from a scope, since that
+// may be gone by the time it allocates again.
+void Any::Release()
+{
+  if(!m_HoldsReference && m_MetaData && m_Data)
+  {
+    const Meta::LifetimeTable &lifetime = m_MetaData->GetLifetime();
+
+    if(m_IsInline)
+    {
+      // Trivial destructors don't have a function to call.
+      if(lifetime.m_Destroy != nullptr)
+        lifetime.m_Destroy(m_Data);
+    }
+    else
+    {
+      lifetime.DestroyIn(m_Resource, m_Data);
+    }
+  }
+
+  m_Data = nullptr;
+  m_MetaData = nullptr;
+  m_HoldsReference = false;
+  m_IsConst = false;
+  m_IsInline = false;
+
+  if(!m_IsResourceGiven)
+    m_Resource = nullptr;
+}
+
+// Get the resource the Any's heap data is allocated from.  Null means the type's pool
+// or the global new.
+Meta::MemoryResource *Any::GetResource() const
+{
+  return m_Resource;
+}
+
+// Get the resource to allocate data from.  An Any that wasn't given one picks up the
+// scoped resource (if there is one) and keeps it while it holds the data allocated
+// from it, since that is where the data has to be given back to.
+Meta::MemoryResource *Any::GetAllocationResource()
+{
+  if(m_Resource == nullptr)
+    m_Resource = Meta::GetScopedResource();
+
+  return m_Resource;
 }
@@ -7,17 +7,40 @@ Author: Alex Troyer
 
 #include "Meta.h"
 #include "Error.h"
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+class Any;
+
+// Keeps the forwarding constructor and assignment of Any from being picked over the
+// copy and move versions when given another Any, or over the memory resource
+// constructor when given a resource.
+template<typename T>
+using EnableIfStorable = typename std::enable_if<!std::is_same<typename std::decay<T>::type, Any>::value &&
+                                                 !(std::is_pointer<typename std::decay<T>::type>::value &&
+                                                   std::is_base_of<Meta::MemoryResource, 
+                                                                   typename std::remove_pointer<typename std::decay<T>::type>::type>::value)>::type;
+
+// See if an Any can construct the object as the type its meta data describes.  This
+// isn't true for things like pointers, since the meta data is for the type pointed to.
+template<typename T>
+using CanStoreValue = std::integral_constant<bool, std::is_same<typename std::decay<T>::type, GET_TYPE(T)>::value &&
+                                                   std::is_constructible<typename std::decay<T>::type, T &&>::value>;
 
 class Any
 {
 public:
   Any() = default;
   Any(Meta::Data *metaData);
+  explicit Any(Meta::MemoryResource *resource);
+  Any(Meta::Data *metaData, Meta::MemoryResource *resource);
   Any(const Any &any);
   Any(Any &&any);
 
-  template<typename T>
-  Any(const T &rhs);
+  template<typename T, typename = EnableIfStorable<T>>
+  Any(T &&rhs);
 
   template<typename T>
   static Any AnyRef(T &rhs);
@@ -25,20 +48,26 @@ public:
   template<typename T>
   static Any AnyRef(const T &rhs);
 
+  static Any AnyRef(void *data, Meta::Data *metaData);
+  static Any AnyRef(const void *data, Meta::Data *metaData);
+
   ~Any();
 
   template<typename T>
   operator T&() const;
 
-  template<typename T>
-  T &operator=(const T &rhs);
+  template<typename T, typename = EnableIfStorable<T>>
+  typename std::decay<T>::type &operator=(T &&rhs);
 
   Any &operator=(const Any &rhs);
 
   Any &operator=(Any &&rhs);
 
   template<typename T>
-  void Set(const T &rhs);
+  void Set(T &&rhs);
+
+  template<typename T, typename ...Args>
+  T &Emplace(Args &&...args);
 
   template<typename T>
   void SetReference(T &rhs);
@@ -48,16 +77,76 @@ public:
   template<typename T>
   T &Get() const;
 
+  template<typename T>
+  bool Is() const;
+
+  template<typename T>
+  T *TryGet() const;
+
+  template<typename Visitor>
+  bool Visit(Visitor &&visitor) const;
+
   void *GetInternal() const;
   Meta::Data *GetMeta() const;
   bool IsConst() const;
   bool HoldsReference() const;
+  bool IsInline() const;
+  Meta::MemoryResource *GetResource() const;
+
+  size_t Hash() const;
+  bool operator==(const Any &rhs) const;
+  bool operator!=(const Any &rhs) const;
+
+  // Types this size or smaller are kept inside of the Any instead of on the heap.
+  static const size_t BufferSize = 32;
+  static const size_t BufferAlignment = alignof(std::max_align_t);
+
+  // See if a type will be kept inside of the Any.  It also has to be able to move without
+  // throwing, since moving the Any moves the object.
+  template<typename T>
+  static constexpr bool StoresInline();
+  static bool StoresInline(Meta::Data *metaData);
 
 private:
+  template<typename T>
+  void Store(T &&rhs, std::true_type);
+  template<typename T>
+  void Store(T &&rhs, std::false_type);
+  template<typename T>
+  void StoreCopy(const T &rhs);
+  void CopyFrom(const Any &rhs);
+  void MoveFrom(Any &rhs);
+  void Release();
+  Meta::MemoryResource *GetAllocationResource();
+
+  template<typename Visitor, typename T, typename ...Types>
+  bool VisitTypes(Visitor &visitor, Meta::TypeList<T, Types...>) const;
+  template<typename Visitor>
+  bool VisitTypes(Visitor &visitor, Meta::TypeList<>) const;
+
   void *m_Data = nullptr;
   Meta::Data *m_MetaData = nullptr;
+  Meta::MemoryResource *m_Resource = nullptr;
   bool m_HoldsReference = false;
   bool m_IsConst = false;
+  bool m_IsInline = false;
+  // Whether the resource was given to the constructor, instead of picked up from a
+  // scope for the data being held.
+  bool m_IsResourceGiven = false;
+  std::aligned_storage<BufferSize, BufferAlignment>::type m_Buffer;
 };
 
+namespace std
+{
+  // Lets an Any be used as a key in hashed containers.
+  template<>
+  struct hash<Any>
+  {
+    size_t operator()(const Any &any) const
+    {
+      return any.Hash();
+    }
+  };
+}
+
 #include "Any.hpp"
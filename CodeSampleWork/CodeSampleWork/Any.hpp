@@ -5,14 +5,20 @@ Author: Alex Troyer
 *****************************************************************************/
 #pragma once
 
-// Construct an Any by copying the given object.
+// See if a type will be kept inside of the Any instead of on the heap.
 template<typename T>
-Any::Any(const T &rhs)
-  : m_MetaData(GET_META(T))
+constexpr bool Any::StoresInline()
 {
-  m_Data = m_MetaData->GetObjectInfo()->Copy(&rhs);
+  return sizeof(T) <= BufferSize && 
+         alignof(T) <= BufferAlignment && 
+         std::is_nothrow_move_constructible<T>::value;
+}
 
-  FATAL_ERROR_IF(m_Data == nullptr, m_MetaData->GetName() + " doesn't have a copy constructor!");
+// Construct an Any from the given object.  Temporaries are moved in instead of copied.
+template<typename T, typename>
+Any::Any(T &&rhs)
+{
+  Store(std::forward<T>(rhs), CanStoreValue<T>());
 }
 
 // Create a reference to an object and store it in the Any.
@@ -43,62 +49,74 @@ Any::operator T&() const
   return Get<T>();
 }
 
-// Assignment operator from another type by copying the data.
-template<typename T>
-T &Any::operator=(const T &rhs)
+// Assignment operator from another type.  Temporaries are moved in instead of copied.
+template<typename T, typename>
+typename std::decay<T>::type &Any::operator=(T &&rhs)
 {
+  typedef typename std::decay<T>::type Type;
+
+  // The types are the same, use the assignment operator of the type.
   // We can't assign to the data if this is const.
-  if(!m_IsConst)
+  if(!m_IsConst && m_MetaData == GET_META(T))
   {
-    // The types are the same, use the assignment operator of the type.
-    if(m_MetaData == GET_META(T))
-    {
-      return *reinterpret_cast<T *>(m_Data) = rhs;
-    }
-    // Otherwise we need to destroy the data since we are changing types.
-    // Don't destroy the data if we have no type information or we are holding a
-    // reference.
-    else if(m_MetaData && !m_HoldsReference)
-    {
-      m_MetaData->GetObjectInfo()->Destroy(m_Data);
-    }
+    return *reinterpret_cast<Type *>(m_Data) = std::forward<T>(rhs);
   }
 
-  m_MetaData = GET_META(T);
-  // Make a copy of the data.
-  m_Data = m_MetaData->GetObjectInfo()->Copy(&rhs);
-  m_HoldsReference = false;
-  m_IsConst = false;
-
-  // Error if the class doesn't have a copy constructor.
-  FATAL_ERROR_IF(m_Data == nullptr, m_MetaData->GetName() + " doesn't have a copy constructor!");
+  // Otherwise get rid of what we have since we are changing types.
+  Release();
+  Store(std::forward<T>(rhs), CanStoreValue<T>());
 
-  return *reinterpret_cast<T *>(m_Data);
+  return *reinterpret_cast<Type *>(m_Data);
 }
 
 // Calls the assignment operator for assigning an object to an Any.
 template<typename T>
-void Any::Set(const T &rhs)
+void Any::Set(T &&rhs)
+{
+  *this = std::forward<T>(rhs);
+}
+
+// Construct an object of the given type right inside of the Any from the arguments,
+// so nothing has to be copied or moved in.
+template<typename T, typename ...Args>
+T &Any::Emplace(Args &&...args)
 {
-  *this = rhs;
+  Release();
+
+  m_MetaData = GET_META(T);
+  m_IsInline = StoresInline<T>();
+
+  if(m_IsInline)
+  {
+    m_Data = new (&m_Buffer) T(std::forward<Args>(args)...);
+  }
+  else
+  {
+    // Allocate through the object info, since that is what destroys it.
+    m_Data = new (m_MetaData->GetLifetime().Allocate(GetAllocationResource())) T(std::forward<Args>(args)...);
+  }
+
+  return *reinterpret_cast<T *>(m_Data);
 }
 
 // Set a reference to the object.  A reference will not be destroyed by the Any.
 template<typename T>
 void Any::SetReference(T &rhs)
 {
+  Release();
+
   m_HoldsReference = true;
   m_MetaData = GET_META(T);
   m_Data = reinterpret_cast<void *>(&rhs);
 }
 
-// Set a reference to a const object. This will not be destroyed or assigned over,
-// but this could be a bit dangerous.  Be careful when using this.
+// Set a reference to a const object.  This will not be destroyed or assigned over.
+// Assigning to the Any replaces the reference with a value instead.
 template<typename T>
 void Any::SetReference(const T &rhs)
 {
   SetReference(const_cast<T &>(rhs));
-  m_IsConst = false;
+  m_IsConst = true;
 }
 
 // Get the data casted as the given type.
@@ -106,4 +124,101 @@ template<typename T>
 T &Any::Get() const
 {
   return *reinterpret_cast<T *>(m_Data);
+}
+
+// See if the Any holds the given type.  A type's meta data never moves, so this is just
+// a pointer compare (and it won't build a lazily registered type).  T has to be the
+// type itself, since the meta data of a pointer is the meta data of what it points to.
+template<typename T>
+bool Any::Is() const
+{
+  static_assert(std::is_same<typename std::remove_const<T>::type, GET_TYPE(T)>::value, "Any::Is needs a value type, not a pointer or reference!");
+
+  return m_Data != nullptr && m_MetaData == Meta::DataStorage<GET_TYPE(T)>::PeekData();
+}
+
+// Get the data as the given type, or null if the Any holds something else.  An empty
+// Any has no data, so this only has to compare the meta data.  A const object (like a
+// reference from GetRef on a const object) is only handed out if T is const too.
+// Like Is, T can't be a pointer or reference.
+template<typename T>
+T *Any::TryGet() const
+{
+  static_assert(std::is_same<typename std::remove_const<T>::type, GET_TYPE(T)>::value, "Any::TryGet needs a value type, not a pointer or reference!");
+
+  if(m_IsConst && !std::is_const<T>::value)
+    return nullptr;
+
+  return m_MetaData == Meta::DataStorage<GET_TYPE(T)>::PeekData() ? reinterpret_cast<T *>(m_Data) : nullptr;
+}
+
+// Call the visitor with the data if it is one of the basic types (Meta::BasicTypes).
+// Returns false without calling it if the Any holds anything else.  A const object is
+// passed to the visitor as const.
+template<typename Visitor>
+bool Any::Visit(Visitor &&visitor) const
+{
+  return VisitTypes(visitor, Meta::BasicTypes());
+}
+
+// Check the types one at a time until one matches.
+template<typename Visitor, typename T, typename ...Types>
+bool Any::VisitTypes(Visitor &visitor, Meta::TypeList<T, Types...>) const
+{
+  if(const T *data = TryGet<const T>())
+  {
+    if(m_IsConst)
+      visitor(*data);
+    else
+      visitor(*const_cast<T *>(data));
+
+    return true;
+  }
+
+  return VisitTypes(visitor, Meta::TypeList<Types...>());
+}
+
+// Ran out of types to check.
+template<typename Visitor>
+bool Any::VisitTypes(Visitor &, Meta::TypeList<>) const
+{
+  return false;
+}
+
+// Store an object that can be constructed as the type the meta data describes,
+// moving it if we can.
+template<typename T>
+void Any::Store(T &&rhs, std::true_type)
+{
+  Emplace<typename std::decay<T>::type>(std::forward<T>(rhs));
+}
+
+// Anything else, like a pointer, goes through the copy constructor in the object info.
+template<typename T>
+void Any::Store(T &&rhs, std::false_type)
+{
+  StoreCopy(rhs);
+}
+
+// Store a copy of the object.  Small objects are copied into the buffer so this
+// doesn't allocate.  Anything that was in the Any must already be released.
+template<typename T>
+void Any::StoreCopy(const T &rhs)
+{
+  m_MetaData = GET_META(T);
+  m_IsInline = StoresInline<GET_TYPE(T)>();
+
+  if(m_IsInline)
+  {
+    FATAL_ERROR_IF(!std::is_copy_constructible<GET_TYPE(T)>::value, m_MetaData->GetName() + " doesn't have a copy constructor!");
+
+    m_Data = &m_Buffer;
+    Meta::PlacementCopy<GET_TYPE(T)>(m_Data, &rhs);
+  }
+  else
+  {
+    m_Data = m_MetaData->GetLifetime().CopyIn(GetAllocationResource(), &rhs);
+
+    FATAL_ERROR_IF(m_Data == nullptr, m_MetaData->GetName() + " doesn't have a copy constructor!");
+  }
 }
\ No newline at end of file
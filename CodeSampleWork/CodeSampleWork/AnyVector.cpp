@@ -0,0 +1,388 @@
+/*****************************************************************************
+File:   AnyVector.cpp
+Author: Alex Troyer
+  A vector of objects of one type that is only known at runtime through its
+  meta data.
+*****************************************************************************/
+#include "AnyVector.h"
+#include <algorithm>
+#include <new>
+
+DEFINE_SIMPLE_TYPE(AnyVector);
+
+///////////////////////////////////////////////////////////////
+// Iterator
+///////////////////////////////////////////////////////////////
+
+AnyVector::Iterator::Iterator(char *element, size_t stride, Meta::Data *metaData)
+  : m_Element(element)
+  , m_Stride(stride)
+  , m_MetaData(metaData)
+{
+}
+
+// Get the element as an Any that references it, so nothing is copied.
+Any AnyVector::Iterator::operator*() const
+{
+  return Any::AnyRef(m_Element, m_MetaData);
+}
+
+AnyVector::Iterator &AnyVector::Iterator::operator++()
+{
+  m_Element += m_Stride;
+  return *this;
+}
+
+bool AnyVector::Iterator::operator==(const Iterator &rhs) const
+{
+  return m_Element == rhs.m_Element;
+}
+
+bool AnyVector::Iterator::operator!=(const Iterator &rhs) const
+{
+  return m_Element != rhs.m_Element;
+}
+
+///////////////////////////////////////////////////////////////
+// AnyVector
+///////////////////////////////////////////////////////////////
+
+// Make an empty vector of the given type.  The elements are allocated from the given
+// resource, or the global new if there isn't one.  The resource has to outlive the vector.
+AnyVector::AnyVector(Meta::Data *metaData, Meta::MemoryResource *resource)
+  : m_MetaData(metaData)
+  , m_Resource(resource)
+{
+  FATAL_ERROR_IF(resource == nullptr && metaData->GetLifetime().m_Alignment > alignof(std::max_align_t),
+                 metaData->GetName() + " needs a memory resource to be aligned in an AnyVector!");
+}
+
+// Copy every element of the other vector.  Like Any, the copy doesn't keep the resource.
+AnyVector::AnyVector(const AnyVector &rhs)
+{
+  CopyFrom(rhs);
+}
+
+// Take the elements of the other vector along with where their memory came from.
+AnyVector::AnyVector(AnyVector &&rhs)
+{
+  MoveFrom(rhs);
+}
+
+AnyVector::~AnyVector()
+{
+  Release();
+}
+
+AnyVector &AnyVector::operator=(const AnyVector &rhs)
+{
+  if(this != &rhs)
+  {
+    Release();
+    CopyFrom(rhs);
+  }
+
+  return *this;
+}
+
+AnyVector &AnyVector::operator=(AnyVector &&rhs)
+{
+  if(this != &rhs)
+  {
+    Release();
+    MoveFrom(rhs);
+  }
+
+  return *this;
+}
+
+// Vectors are the same if they hold the same type and every element is the same by
+// the type's ==.  Elements of a type without an == are never the same.
+bool AnyVector::operator==(const AnyVector &rhs) const
+{
+  if(m_MetaData != rhs.m_MetaData || m_Size != rhs.m_Size)
+    return false;
+
+  if(m_Size == 0)
+    return true;
+
+  Meta::LifetimeTable::EqualFn equal = m_MetaData->GetLifetime().m_Equal;
+
+  if(equal == nullptr)
+    return false;
+
+  size_t stride = GetStride();
+
+  for(size_t i = 0; i < m_Size; ++i)
+  {
+    if(!equal(m_Data + i * stride, rhs.m_Data + i * stride))
+      return false;
+  }
+
+  return true;
+}
+
+bool AnyVector::operator!=(const AnyVector &rhs) const
+{
+  return !(*this == rhs);
+}
+
+// Get an element as an Any that references it, or an empty Any if it is out of range.
+Any AnyVector::operator[](size_t index) const
+{
+  void *element = GetElement(index);
+
+  if(element == nullptr)
+    return Any();
+
+  return Any::AnyRef(element, m_MetaData);
+}
+
+// Get a pointer to an element, or null if it is out of range.
+void *AnyVector::GetElement(size_t index) const
+{
+  FATAL_ERROR_IF(index >= m_Size, "AnyVector index out of range!");
+
+  if(index >= m_Size)
+    return nullptr;
+
+  return m_Data + index * GetStride();
+}
+
+// Copy the object in the Any onto the end.  It has to be the same type as the vector.
+void AnyVector::PushBack(const Any &value)
+{
+  if(!CheckType(value.GetMeta()))
+    return;
+
+  const Meta::LifetimeTable &lifetime = m_MetaData->GetLifetime();
+
+  FATAL_ERROR_IF(lifetime.m_Copy == nullptr, m_MetaData->GetName() + " doesn't have a copy constructor!");
+
+  if(lifetime.m_Copy == nullptr)
+    return;
+
+  const void *object = value.GetInternal();
+
+  Append([&lifetime, object](void *ptr)
+  {
+    lifetime.m_Copy(ptr, object);
+  });
+}
+
+// Destroy the last element.
+void AnyVector::PopBack()
+{
+  FATAL_ERROR_IF(m_Size == 0, "Popped an empty AnyVector!");
+
+  if(m_Size == 0)
+    return;
+
+  --m_Size;
+
+  if(m_MetaData->GetLifetime().m_Destroy != nullptr)
+    m_MetaData->GetLifetime().m_Destroy(m_Data + m_Size * GetStride());
+}
+
+// Change the number of elements.  New ones are default constructed and extra ones
+// are destroyed.
+void AnyVector::Resize(size_t size)
+{
+  const Meta::LifetimeTable &lifetime = m_MetaData->GetLifetime();
+  size_t stride = GetStride();
+
+  if(size < m_Size)
+  {
+    m_MetaData->GetObjectInfo()->DestroyN(m_Data + size * stride, m_Size - size);
+  }
+  else if(size > m_Size)
+  {
+    FATAL_ERROR_IF(lifetime.m_Construct == nullptr, m_MetaData->GetName() + " doesn't have a default constructor!");
+
+    if(lifetime.m_Construct == nullptr)
+      return;
+
+    if(size > m_Capacity)
+      Reserve(std::max(size, GetGrowCapacity()));
+
+    if(size > m_Capacity)
+      return;
+
+    m_MetaData->GetObjectInfo()->ConstructN(m_Data + m_Size * stride, size - m_Size);
+  }
+
+  m_Size = size;
+}
+
+// Make room for at least the given number of elements without adding any.
+void AnyVector::Reserve(size_t capacity)
+{
+  if(capacity > m_Capacity && CanMove())
+    MoveTo(Allocate(capacity), capacity);
+}
+
+// Destroy every element.  The memory is kept for new ones.
+void AnyVector::Clear()
+{
+  if(m_Size > 0)
+    m_MetaData->GetObjectInfo()->DestroyN(m_Data, m_Size);
+
+  m_Size = 0;
+}
+
+AnyVector::Iterator AnyVector::begin() const
+{
+  return Iterator(m_Data, GetStride(), m_MetaData);
+}
+
+AnyVector::Iterator AnyVector::end() const
+{
+  return Iterator(m_Data + m_Size * GetStride(), GetStride(), m_MetaData);
+}
+
+size_t AnyVector::GetSize() const
+{
+  return m_Size;
+}
+
+size_t AnyVector::GetCapacity() const
+{
+  return m_Capacity;
+}
+
+bool AnyVector::IsEmpty() const
+{
+  return m_Size == 0;
+}
+
+// Get the type of the elements.
+Meta::Data *AnyVector::GetMeta() const
+{
+  return m_MetaData;
+}
+
+// Get the resource the elements are allocated from.  Null means the global new.
+Meta::MemoryResource *AnyVector::GetResource() const
+{
+  return m_Resource;
+}
+
+// Make sure an object being added is the type of the vector.  Returns false if it isn't.
+bool AnyVector::CheckType(Meta::Data *metaData) const
+{
+  FATAL_ERROR_IF(m_MetaData == nullptr, "AnyVector doesn't have a type!");
+
+  if(m_MetaData == nullptr)
+    return false;
+
+  FATAL_ERROR_IF(metaData != m_MetaData, "Added a " + (metaData ? metaData->GetName() : std::string("null")) +
+                                         " to an AnyVector of " + m_MetaData->GetName() + "!");
+
+  return metaData == m_MetaData;
+}
+
+// See if the elements can be moved into new memory.  An empty vector always can.
+bool AnyVector::CanMove() const
+{
+  bool canMove = m_Size == 0 || m_MetaData->GetLifetime().m_Relocate != nullptr;
+
+  FATAL_ERROR_IF(!canMove, m_MetaData->GetName() + " can't be moved to grow an AnyVector!");
+
+  return canMove;
+}
+
+// Get how far apart elements are.  The size of a type is always a multiple of its
+// alignment, so this is just the size.
+size_t AnyVector::GetStride() const
+{
+  return m_MetaData != nullptr ? m_MetaData->GetLifetime().m_Size : 0;
+}
+
+// Get how many elements to make room for the next time the vector fills up.
+size_t AnyVector::GetGrowCapacity() const
+{
+  return m_Capacity == 0 ? 8 : m_Capacity * 2;
+}
+
+// Get memory for the given number of elements.
+char *AnyVector::Allocate(size_t capacity) const
+{
+  const Meta::LifetimeTable &lifetime = m_MetaData->GetLifetime();
+  size_t size = capacity * lifetime.m_Size;
+
+  if(m_Resource != nullptr)
+    return static_cast<char *>(m_Resource->Allocate(size, lifetime.m_Alignment));
+
+  return static_cast<char *>(::operator new(size));
+}
+
+// Give back memory from Allocate.
+void AnyVector::Deallocate(char *data, size_t capacity) const
+{
+  if(data == nullptr)
+    return;
+
+  const Meta::LifetimeTable &lifetime = m_MetaData->GetLifetime();
+
+  if(m_Resource != nullptr)
+    m_Resource->Deallocate(data, capacity * lifetime.m_Size, lifetime.m_Alignment);
+  else
+    ::operator delete(data);
+}
+
+// Relocate the elements into new memory and give back the old memory.  Plain data
+// is moved over with one memcpy.  Check CanMove before getting the new memory.
+void AnyVector::MoveTo(char *data, size_t capacity)
+{
+  if(m_Size > 0)
+    m_MetaData->GetLifetime().m_Relocate(data, m_Data, m_Size);
+
+  Deallocate(m_Data, m_Capacity);
+
+  m_Data = data;
+  m_Capacity = capacity;
+}
+
+// Copy every element of another vector.  Anything in this one must already be released.
+void AnyVector::CopyFrom(const AnyVector &rhs)
+{
+  m_MetaData = rhs.m_MetaData;
+
+  if(rhs.m_Size == 0)
+    return;
+
+  FATAL_ERROR_IF(!m_MetaData->GetObjectInfo()->HasCopyConstructor(), m_MetaData->GetName() + " doesn't have a copy constructor!");
+
+  if(!m_MetaData->GetObjectInfo()->HasCopyConstructor())
+    return;
+
+  m_Data = Allocate(rhs.m_Size);
+  m_Capacity = rhs.m_Size;
+  m_MetaData->GetObjectInfo()->CopyN(m_Data, rhs.m_Data, rhs.m_Size);
+  m_Size = rhs.m_Size;
+}
+
+// Take the elements of another vector, leaving it empty but still the same type.
+// Anything in this one must already be released.
+void AnyVector::MoveFrom(AnyVector &rhs)
+{
+  m_Data = rhs.m_Data;
+  m_MetaData = rhs.m_MetaData;
+  m_Resource = rhs.m_Resource;
+  m_Size = rhs.m_Size;
+  m_Capacity = rhs.m_Capacity;
+
+  rhs.m_Data = nullptr;
+  rhs.m_Size = 0;
+  rhs.m_Capacity = 0;
+}
+
+// Destroy every element and give back the memory.
+void AnyVector::Release()
+{
+  Clear();
+  Deallocate(m_Data, m_Capacity);
+
+  m_Data = nullptr;
+  m_Capacity = 0;
+}
@@ -0,0 +1,101 @@
+/*****************************************************************************
+File:   AnyVector.h
+Author: Alex Troyer
+  A vector of objects of one type that is only known at runtime through its
+  meta data.  The objects are kept next to each other like a std::vector,
+  instead of each one being in its own Any.
+*****************************************************************************/
+#pragma once
+
+#include "Meta.h"
+#include "Any.h"
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+class AnyVector
+{
+public:
+  // Walks through the elements, giving each one as an Any that references it.
+  class Iterator
+  {
+  public:
+    Iterator(char *element, size_t stride, Meta::Data *metaData);
+
+    Any operator*() const;
+    Iterator &operator++();
+    bool operator==(const Iterator &rhs) const;
+    bool operator!=(const Iterator &rhs) const;
+
+  private:
+    char *m_Element;
+    size_t m_Stride;
+    Meta::Data *m_MetaData;
+  };
+
+  AnyVector() = default;
+  explicit AnyVector(Meta::Data *metaData, Meta::MemoryResource *resource = nullptr);
+  AnyVector(const AnyVector &rhs);
+  AnyVector(AnyVector &&rhs);
+  ~AnyVector();
+
+  AnyVector &operator=(const AnyVector &rhs);
+  AnyVector &operator=(AnyVector &&rhs);
+
+  bool operator==(const AnyVector &rhs) const;
+  bool operator!=(const AnyVector &rhs) const;
+
+  Any operator[](size_t index) const;
+  void *GetElement(size_t index) const;
+
+  template<typename T>
+  T &Get(size_t index) const;
+
+  template<typename T>
+  T *GetData() const;
+
+  void PushBack(const Any &value);
+
+  template<typename T, typename = EnableIfStorable<T>>
+  void PushBack(T &&value);
+
+  template<typename T, typename ...Args>
+  T *EmplaceBack(Args &&...args);
+
+  void PopBack();
+  void Resize(size_t size);
+  void Reserve(size_t capacity);
+  void Clear();
+
+  Iterator begin() const;
+  Iterator end() const;
+
+  size_t GetSize() const;
+  size_t GetCapacity() const;
+  bool IsEmpty() const;
+  Meta::Data *GetMeta() const;
+  Meta::MemoryResource *GetResource() const;
+
+private:
+  template<typename Construct>
+  void Append(Construct construct);
+
+  bool CheckType(Meta::Data *metaData) const;
+  bool CanMove() const;
+  size_t GetStride() const;
+  size_t GetGrowCapacity() const;
+  char *Allocate(size_t capacity) const;
+  void Deallocate(char *data, size_t capacity) const;
+  void MoveTo(char *data, size_t capacity);
+  void CopyFrom(const AnyVector &rhs);
+  void MoveFrom(AnyVector &rhs);
+  void Release();
+
+  char *m_Data = nullptr;
+  Meta::Data *m_MetaData = nullptr;
+  Meta::MemoryResource *m_Resource = nullptr;
+  size_t m_Size = 0;
+  size_t m_Capacity = 0;
+};
+
+#include "AnyVector.hpp"
@@ -0,0 +1,79 @@
+/*****************************************************************************
+File:   AnyVector.hpp
+Author: Alex Troyer
+  A vector of objects of one type that is only known at runtime through its
+  meta data.
+*****************************************************************************/
+#pragma once
+
+// Get an element as the given type.  Like Any::Get, this doesn't check the type.
+template<typename T>
+T &AnyVector::Get(size_t index) const
+{
+  return *reinterpret_cast<T *>(GetElement(index));
+}
+
+// Get the elements as an array of the given type, or null if they are something else.
+// A pointer or const type is never the type of the elements.
+template<typename T>
+T *AnyVector::GetData() const
+{
+  if(!std::is_same<T, GET_TYPE(T)>::value)
+    return nullptr;
+
+  return m_MetaData == Meta::DataStorage<GET_TYPE(T)>::PeekData() ? reinterpret_cast<T *>(m_Data) : nullptr;
+}
+
+// Add an object to the end.  Temporaries are moved in instead of copied.
+template<typename T, typename>
+void AnyVector::PushBack(T &&value)
+{
+  EmplaceBack<typename std::decay<T>::type>(std::forward<T>(value));
+}
+
+// Construct an object at the end with the given arguments.  Gives back the new element,
+// or null if the vector isn't of that type.
+template<typename T, typename ...Args>
+T *AnyVector::EmplaceBack(Args &&...args)
+{
+  static_assert(std::is_same<T, GET_TYPE(T)>::value, "AnyVector only stores values, not pointers, references or const objects!");
+
+  if(!CheckType(GET_META(T)))
+    return nullptr;
+
+  T *element = nullptr;
+
+  Append([&element, &args...](void *ptr)
+  {
+    element = new (ptr) T(std::forward<Args>(args)...);
+  });
+
+  return element;
+}
+
+// Build a new element at the end with the given function.  When it has to grow, the
+// new element is built in the new memory before the old elements are moved over, so
+// the arguments are still good even if they are elements of this vector.
+template<typename Construct>
+void AnyVector::Append(Construct construct)
+{
+  size_t stride = GetStride();
+
+  if(m_Size == m_Capacity)
+  {
+    if(!CanMove())
+      return;
+
+    size_t capacity = GetGrowCapacity();
+    char *data = Allocate(capacity);
+
+    construct(data + m_Size * stride);
+    MoveTo(data, capacity);
+  }
+  else
+  {
+    construct(m_Data + m_Size * stride);
+  }
+
+  ++m_Size;
+}
@@ -0,0 +1,60 @@
+/*****************************************************************************
+File:   Arena.cpp
+Author: Alex Troyer
+  A bump allocator that all of the meta data is built in.
+*****************************************************************************/
+#include "Arena.h"
+#include <cstdint>
+
+namespace Meta
+{
+  // Get memory for an object of the given size.  This locks since types can be
+  // registered from more than one thread.
+  void *Arena::Allocate(size_t size, size_t alignment)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    std::uintptr_t current = reinterpret_cast<std::uintptr_t>(m_Current);
+    std::uintptr_t aligned = (current + alignment - 1) & ~(alignment - 1);
+
+    // Start a new block if this doesn't fit in what is left of the current one.
+    // Anything bigger than a block gets a block of its own.
+    if(m_Current == nullptr || aligned + size > reinterpret_cast<std::uintptr_t>(m_End))
+    {
+      size_t blockSize = size + alignment > BlockSize ? size + alignment : BlockSize;
+
+      m_Current = static_cast<char *>(::operator new(blockSize));
+      m_End = m_Current + blockSize;
+      ++m_BlockCount;
+
+      current = reinterpret_cast<std::uintptr_t>(m_Current);
+      aligned = (current + alignment - 1) & ~(alignment - 1);
+    }
+
+    m_Current = reinterpret_cast<char *>(aligned + size);
+    m_BytesUsed += size;
+
+    return reinterpret_cast<void *>(aligned);
+  }
+
+  // Get how many blocks have been allocated.
+  size_t Arena::GetBlockCount() const
+  {
+    return m_BlockCount;
+  }
+
+  // Get how many bytes have been handed out (not counting alignment padding).
+  size_t Arena::GetBytesUsed() const
+  {
+    return m_BytesUsed;
+  }
+
+  // The arena everything registered to the meta system lives in.  Like the other
+  // registry storage, it is constructed on first use and never destroyed, so it is
+  // there no matter which static registration runs first or last.
+  Arena &GetRegistryArena()
+  {
+    static Arena *arena = new Arena();
+    return *arena;
+  }
+}
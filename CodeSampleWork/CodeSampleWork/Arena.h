@@ -0,0 +1,53 @@
+/*****************************************************************************
+File:   Arena.h
+Author: Alex Troyer
+  A bump allocator that all of the meta data is built in.
+*****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+
+namespace Meta
+{
+  // Hands out memory by bumping a pointer through large blocks.  Nothing is ever freed
+  // or moved, so addresses are stable and there is no per allocation bookkeeping.
+  // Objects built in it are never destroyed, which is fine for meta data since it
+  // lives until the program ends.
+  class Arena
+  {
+  public:
+    static const size_t BlockSize = 64 * 1024;
+
+    Arena() = default;
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *Allocate(size_t size, size_t alignment);
+
+    template<typename T, typename ...Args>
+    T *New(Args &&...args);
+    template<typename T>
+    T *NewArray(size_t count);
+
+    size_t GetBlockCount() const;
+    size_t GetBytesUsed() const;
+
+  private:
+    std::mutex m_Mutex;
+    char *m_Current = nullptr;
+    char *m_End = nullptr;
+    size_t m_BlockCount = 0;
+    size_t m_BytesUsed = 0;
+  };
+
+  Arena &GetRegistryArena();
+
+  template<typename T, typename ...Args>
+  T *ArenaNew(Args &&...args);
+  template<typename T>
+  T *ArenaNewArray(size_t count);
+}
+
+#include "Arena.hpp"
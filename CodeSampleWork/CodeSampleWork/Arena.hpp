@@ -0,0 +1,47 @@
+/*****************************************************************************
+File:   Arena.hpp
+Author: Alex Troyer
+  A bump allocator that all of the meta data is built in.
+*****************************************************************************/
+#pragma once
+
+#include <new>
+#include <utility>
+
+namespace Meta
+{
+  // Construct an object in the arena.
+  template<typename T, typename ...Args>
+  T *Arena::New(Args &&...args)
+  {
+    return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  // Default construct an array of objects in the arena, next to each other.
+  template<typename T>
+  T *Arena::NewArray(size_t count)
+  {
+    T *objects = static_cast<T *>(Allocate(sizeof(T) * count, alignof(T)));
+
+    for(size_t i = 0; i < count; ++i)
+    {
+      new (objects + i) T();
+    }
+
+    return objects;
+  }
+
+  // Construct meta data in the registry arena.
+  template<typename T, typename ...Args>
+  T *ArenaNew(Args &&...args)
+  {
+    return GetRegistryArena().New<T>(std::forward<Args>(args)...);
+  }
+
+  // Default construct an array of meta data in the registry arena.
+  template<typename T>
+  T *ArenaNewArray(size_t count)
+  {
+    return GetRegistryArena().NewArray<T>(count);
+  }
+}
@@ -0,0 +1,1547 @@
+/*****************************************************************************
+File:   Benchmark.cpp
+Author: Alex Troyer
+  Times the hot paths of the meta system so changes to them can be measured.
+*****************************************************************************/
+#include "Benchmark.h"
+#include "Meta.h"
+#include "Property.h"
+#include "Method.h"
+#include "AnyVector.h"
+#include "PropertyHandle.h"
+#include "MethodHandle.h"
+#include "Diff.h"
+#include "Hash.h"
+#include "AllocationCounter.h"
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <utility>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+// Results get written here so the optimizer can't throw away the work being timed.
+static const void *volatile s_Sink = nullptr;
+
+// Run the function the given number of times and get the average nanoseconds per call.
+template<typename Function>
+static double TimeNanoseconds(size_t iterations, Function function)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for(size_t i = 0; i < iterations; ++i)
+  {
+    function();
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+// Print the timing of one case of a benchmark.
+static void PrintResult(const std::string &name, double nanoseconds)
+{
+  std::cout << name << ": " << nanoseconds << " ns" << std::endl;
+}
+
+// Get how much memory the process has resident right now.
+static size_t GetResidentBytes()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+  return counters.WorkingSetSize;
+#else
+  size_t totalPages = 0;
+  size_t residentPages = 0;
+  std::ifstream statm("/proc/self/statm");
+  statm >> totalPages >> residentPages;
+  return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+static void NameLookupBenchmark()
+{
+  // Compare looking up meta data by name the old way (a std::string keyed map that
+  // has to build and hash a string on every lookup) with the HashedName lookup.
+
+  const size_t iterations = 1000000;
+
+  std::cout << "Benchmark: Name Lookup" << std::endl
+            << "-------------" << std::endl;
+
+  // Build the old style map out of everything registered.
+  std::unordered_map<std::string, Meta::Data *> oldMap;
+
+  for(Meta::TypeId id = 0; id < Meta::TypeTable::GetCount(); ++id)
+  {
+    Meta::Data *data = Meta::TypeTable::Get(id);
+    oldMap.insert({data->GetName(), data});
+  }
+
+  // A name long enough that building a std::string out of it allocates.
+  const std::string longName = "ObjectInfoTestNoDelete";
+
+  PrintResult("Old, short literal", TimeNanoseconds(iterations, [&oldMap]()
+  {
+    s_Sink = oldMap.find("int")->second;
+  }));
+
+  PrintResult("Old, long literal", TimeNanoseconds(iterations, [&oldMap]()
+  {
+    s_Sink = oldMap.find("ObjectInfoTestNoDelete")->second;
+  }));
+
+  PrintResult("Old, std::string", TimeNanoseconds(iterations, [&oldMap, &longName]()
+  {
+    s_Sink = oldMap.find(longName)->second;
+  }));
+
+  PrintResult("New, short literal", TimeNanoseconds(iterations, []()
+  {
+    s_Sink = GET_META_NAME(META_NAME("int"));
+  }));
+
+  PrintResult("New, long literal", TimeNanoseconds(iterations, []()
+  {
+    s_Sink = GET_META_NAME(META_NAME("ObjectInfoTestNoDelete"));
+  }));
+
+  PrintResult("New, std::string", TimeNanoseconds(iterations, [&longName]()
+  {
+    s_Sink = GET_META_NAME(longName);
+  }));
+
+  // Hash once up front, like a loader that keeps the names it resolves around.
+  const Meta::HashedName hashedName(longName);
+
+  PrintResult("New, prehashed", TimeNanoseconds(iterations, [&hashedName]()
+  {
+    s_Sink = GET_META_NAME(hashedName);
+  }));
+
+  std::cout << std::endl;
+}
+
+// A chain of classes N deep to time IsA checks against.
+template<int N>
+class DepthClass : public DepthClass<N - 1>
+{
+};
+
+template<>
+class DepthClass<0>
+{
+};
+
+// Registers the chain of classes at runtime, parents first.  Publishing them after
+// the registry is frozen freezes them.
+template<int N>
+struct DepthClassRegister
+{
+  static void Register()
+  {
+    DepthClassRegister<N - 1>::Register();
+
+    Meta::RegistryWriteLock lock;
+    Meta::DataStorage<DepthClass<N>>::SetData("DepthClass" + std::to_string(N), sizeof(DepthClass<N>),
+                                              Meta::ArenaNew<Meta::ObjectInfo<DepthClass<N>>>());
+    GET_META(DepthClass<N>)->AddParent(GET_META(DepthClass<N - 1>));
+    Meta::DataStorage<DepthClass<N>>::Publish();
+  }
+};
+
+template<>
+struct DepthClassRegister<0>
+{
+  static void Register()
+  {
+    Meta::RegistryWriteLock lock;
+    Meta::DataStorage<DepthClass<0>>::SetData("DepthClass0", sizeof(DepthClass<0>),
+                                              Meta::ArenaNew<Meta::ObjectInfo<DepthClass<0>>>());
+    Meta::DataStorage<DepthClass<0>>::Publish();
+  }
+};
+
+// How checking for a parent used to work, by walking up the parents.
+static bool WalkParents(const Meta::Data *data, const Meta::Data *parent)
+{
+  if(data->GetParent() == nullptr)
+  {
+    return false;
+  }
+  else if(data->GetParent() == parent)
+  {
+    return true;
+  }
+  else
+  {
+    return WalkParents(data->GetParent(), parent);
+  }
+}
+
+static void IsABenchmark()
+{
+  // Compare checking if a type derives from another by walking the parents with the
+  // display lookup, with the parent 1, 4, and 16 levels up.
+
+  const size_t iterations = 10000000;
+
+  std::cout << "Benchmark: IsA" << std::endl
+            << "-------------" << std::endl;
+
+  DepthClassRegister<16>::Register();
+
+  const Meta::Data *root = GET_META(DepthClass<0>);
+  const Meta::Data *depths[] = {GET_META(DepthClass<1>), GET_META(DepthClass<4>), GET_META(DepthClass<16>)};
+
+  for(const Meta::Data *data : depths)
+  {
+    std::string depth = std::to_string(data->GetDepth());
+
+    PrintResult("Walk parents, depth " + depth, TimeNanoseconds(iterations, [data, root]()
+    {
+      s_Sink = WalkParents(data, root) ? data : nullptr;
+    }));
+
+    PrintResult("Display, depth " + depth, TimeNanoseconds(iterations, [data, root]()
+    {
+      s_Sink = data->HasParent(root) ? data : nullptr;
+    }));
+  }
+
+  std::cout << std::endl;
+}
+
+// A bunch of distinct types to register while the stress benchmark is reading.
+template<size_t N>
+class StressClass
+{
+};
+
+// Register a stress class at runtime, the way a plugin would when it's loaded.
+template<size_t N>
+static void RegisterStressClass()
+{
+  Meta::RegistryWriteLock lock;
+  Meta::DataStorage<StressClass<N>>::SetData("StressClass" + std::to_string(N), sizeof(StressClass<N>),
+                                             Meta::ArenaNew<Meta::ObjectInfo<StressClass<N>>>());
+  Meta::DataStorage<StressClass<N>>::Publish();
+}
+
+template<size_t... N>
+static void RegisterStressClasses(std::index_sequence<N...>)
+{
+  int expand[] = {(RegisterStressClass<N>(), 0)...};
+  (void)expand;
+}
+
+// Run reader threads doing name lookups until told to stop, and get how many
+// lookups per second each reader managed.
+template<typename Function>
+static double ReaderThroughput(unsigned readerCount, Function whileReading)
+{
+  std::atomic<bool> done(false);
+  std::atomic<size_t> lookups(0);
+  std::vector<std::thread> readers;
+
+  for(unsigned i = 0; i < readerCount; ++i)
+  {
+    readers.emplace_back([&done, &lookups]()
+    {
+      // Each reader gets its own sink so they aren't racing on the shared one.
+      const void *volatile sink = nullptr;
+      size_t count = 0;
+
+      while(!done.load(std::memory_order_relaxed))
+      {
+        sink = GET_META_NAME(META_NAME("int"));
+        sink = GET_META_NAME(META_NAME("ObjectInfoTestNoDelete"));
+        count += 2;
+      }
+
+      lookups += count;
+    });
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  whileReading();
+  done = true;
+  auto end = std::chrono::high_resolution_clock::now();
+
+  for(std::thread &reader : readers)
+  {
+    reader.join();
+  }
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+
+  return lookups / seconds / readerCount;
+}
+
+static void RegistryStressBenchmark()
+{
+  // Measure name lookup throughput on reader threads, first with nothing else going
+  // on, then while another thread registers types at runtime.
+
+  const size_t registerCount = 512;
+  const unsigned readerCount = 4;
+
+  std::cout << "Benchmark: Registry Stress" << std::endl
+            << "-------------" << std::endl;
+
+  Meta::TypeId typeCount = Meta::TypeTable::GetCount();
+  std::chrono::duration<double> registerTime(0);
+
+  double registering = ReaderThroughput(readerCount, [&registerTime]()
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    RegisterStressClasses(std::make_index_sequence<registerCount>());
+    registerTime = std::chrono::high_resolution_clock::now() - start;
+  });
+
+  // Give the idle readers the same amount of time the registering ones had.
+  double idle = ReaderThroughput(readerCount, [&registerTime]()
+  {
+    std::this_thread::sleep_for(registerTime);
+  });
+
+  // The readers are all joined, so nobody can be holding an old snapshot.
+  Meta::NamedMetaStorage::ReclaimSnapshots();
+
+  bool found = GET_META_NAME("StressClass" + std::to_string(registerCount - 1)) ==
+               GET_META(StressClass<registerCount - 1>);
+
+  std::cout << "Registered " << Meta::TypeTable::GetCount() - typeCount << " types in "
+            << registerTime.count() * 1000.0 << " ms"
+            << (found ? "" : " (last type not found!)") << std::endl;
+  std::cout << "Lookups per second per reader, idle: " << idle << std::endl;
+  std::cout << "Lookups per second per reader, while registering: " << registering << std::endl;
+
+  std::cout << std::endl;
+}
+
+// A class like the ones a big program would link in, with a few members and methods.
+class SyntheticBase
+{
+public:
+  int GetA() const { return m_A; }
+  int AddA(int a) const { return m_A + a; }
+
+  int m_A = 0;
+  float m_B = 0.0f;
+  std::string m_C;
+};
+
+// Each synthetic class is its own type so it gets its own meta data, but they all
+// share the base's layout so the build function is only compiled once.
+template<size_t N, bool Lazy>
+class SyntheticClass : public SyntheticBase
+{
+};
+
+// The build function CLASS_START would make for a synthetic class.  It does the same
+// work (building the properties and methods) for each one.
+static void BuildSyntheticClass(Meta::Data *data)
+{
+  typedef SyntheticBase T;
+
+  MEMBER(m_A);
+  MEMBER(m_B);
+  MEMBER(m_C);
+  METHOD(GetA);
+  METHOD(AddA);
+}
+
+// Register a synthetic class the way CLASS_START does, either building it right away
+// or leaving it to be built on first use.  Publishing is split out since that's just
+// adding the name to the map during static registration, but here (after the registry
+// is frozen) it copies the name map, which would swamp everything else.
+template<size_t N, bool Lazy>
+struct SyntheticClassRegister
+{
+  typedef SyntheticClass<N, Lazy> T;
+
+  static void Register()
+  {
+    Meta::RegistryWriteLock lock;
+    Meta::DataStorage<T>::SetData(std::string(Lazy ? "LazyClass" : "EagerClass") + std::to_string(N), sizeof(T),
+                                  Meta::ArenaNew<Meta::ObjectInfo<SyntheticBase>>());
+
+    // Built types are also flattened when Meta::Freeze is called at startup.
+    if(Lazy)
+    {
+      GET_META(T)->SetBuilder(&BuildSyntheticClass);
+    }
+    else
+    {
+      BuildSyntheticClass(GET_META(T));
+      GET_META(T)->Freeze();
+    }
+  }
+
+  static void Publish()
+  {
+    Meta::DataStorage<T>::Publish();
+  }
+};
+
+// Register all the synthetic classes and get how long it took in milliseconds.  They're
+// registered through tables (instead of one giant function) to keep compile times sane.
+template<bool Lazy, size_t... N>
+static double RegisterSyntheticClasses(std::index_sequence<N...>)
+{
+  static void (*const registerFunctions[])() = {&SyntheticClassRegister<N, Lazy>::Register...};
+  static void (*const publishFunctions[])() = {&SyntheticClassRegister<N, Lazy>::Publish...};
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for(void (*registerFunction)() : registerFunctions)
+  {
+    registerFunction();
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+
+  for(void (*publishFunction)() : publishFunctions)
+  {
+    publishFunction();
+  }
+
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void LazyRegistrationBenchmark()
+{
+  // Compare what static registration costs for a lot of classes when they're all built
+  // up front with registering them lazily, and what it costs to touch a few of them
+  // (like a short lived tool would) afterwards.
+
+  const size_t classCount = 1024;
+  const size_t touchCount = classCount / 100;
+
+  std::cout << "Benchmark: Lazy Registration" << std::endl
+            << "-------------" << std::endl;
+
+  double eager = RegisterSyntheticClasses<false>(std::make_index_sequence<classCount>());
+  double lazy = RegisterSyntheticClasses<true>(std::make_index_sequence<classCount>());
+
+  // Touch the first few by name, which builds them.
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for(size_t i = 0; i < touchCount; ++i)
+  {
+    s_Sink = GET_META_NAME("LazyClass" + std::to_string(i))->GetProperty("m_C");
+  }
+
+  auto touch = std::chrono::high_resolution_clock::now() - start;
+
+  std::cout << classCount << " classes, eager: " << eager << " ms" << std::endl;
+  std::cout << classCount << " classes, lazy: " << lazy << " ms" << std::endl;
+  std::cout << "Building " << touchCount << " lazy classes on first use: "
+            << std::chrono::duration<double, std::milli>(touch).count() << " ms" << std::endl;
+
+  std::cout << std::endl;
+}
+
+// An object with a few plain members to time property access on.
+class PropertyBenchmarkObject
+{
+public:
+  int m_Int = 1;
+  float m_Float = 2.0f;
+  std::string m_String = "A string too long for the small string buffer";
+};
+
+CLASS_START(PropertyBenchmarkObject)
+  MEMBER(m_Int);
+  MEMBER(m_Float);
+  MEMBER(m_String);
+CLASS_END;
+
+// How member properties used to be made, wrapping the member pointer in std::functions.
+template<typename MemberType>
+static Meta::Property *CreateOldMemberProperty(const std::string &name,
+                                               MemberType PropertyBenchmarkObject::*member)
+{
+  auto getFn = [member](const PropertyBenchmarkObject &object)
+  {
+    return object.*member;
+  };
+
+  auto setFn = [member](PropertyBenchmarkObject &object, const MemberType &rhs)
+  {
+    object.*member = rhs;
+  };
+
+  return Meta::ArenaNew<Meta::Property_T<PropertyBenchmarkObject, MemberType, const MemberType &>>(name, getFn, setFn);
+}
+
+// Time getting and setting a member through the old and new properties.
+template<typename MemberType>
+static void TimeMemberProperty(const std::string &name, MemberType PropertyBenchmarkObject::*member)
+{
+  const size_t iterations = 1000000;
+
+  PropertyBenchmarkObject object;
+  const MemberType value = object.*member;
+
+  Meta::Property *oldProperty = CreateOldMemberProperty(name, member);
+  Meta::Property *newProperty = GET_META(PropertyBenchmarkObject)->GetProperty(name);
+
+  PrintResult("Old Get, " + name, TimeNanoseconds(iterations, [oldProperty, &object]()
+  {
+    s_Sink = oldProperty->Get(object).GetInternal();
+  }));
+
+  PrintResult("New Get, " + name, TimeNanoseconds(iterations, [newProperty, &object]()
+  {
+    s_Sink = newProperty->Get(object).GetInternal();
+  }));
+
+  PrintResult("Old Set, " + name, TimeNanoseconds(iterations, [oldProperty, &object, &value]()
+  {
+    oldProperty->Set(object, value);
+  }));
+
+  PrintResult("New Set, " + name, TimeNanoseconds(iterations, [newProperty, &object, &value]()
+  {
+    newProperty->Set(object, value);
+  }));
+}
+
+static void PropertyBenchmark()
+{
+  // Compare getting and setting members through std::functions (the old way) with
+  // going straight to the member's offset.
+
+  std::cout << "Benchmark: Member Properties" << std::endl
+            << "-------------" << std::endl;
+
+  TimeMemberProperty("m_Int", &PropertyBenchmarkObject::m_Int);
+  TimeMemberProperty("m_Float", &PropertyBenchmarkObject::m_Float);
+  TimeMemberProperty("m_String", &PropertyBenchmarkObject::m_String);
+
+  std::cout << std::endl;
+}
+
+static void TypedAccessBenchmark()
+{
+  // Compare summing the ints out of a mix of Anys with no check (only safe when they
+  // are all ints), comparing against GET_META by hand, and TryGet.
+
+  const size_t anyCount = 1024;
+  const size_t iterations = 10000;
+
+  std::cout << "Benchmark: Typed Access" << std::endl
+            << "-------------" << std::endl;
+
+  std::vector<Any> ints;
+  std::vector<Any> mixed;
+
+  for(size_t i = 0; i < anyCount; ++i)
+  {
+    ints.emplace_back(static_cast<int>(i));
+
+    if(i % 2 == 0)
+      mixed.emplace_back(static_cast<int>(i));
+    else
+      mixed.emplace_back(static_cast<float>(i));
+  }
+
+  volatile int sum = 0;
+
+  PrintResult("Get, all ints", TimeNanoseconds(iterations, [&ints, &sum]()
+  {
+    int total = 0;
+
+    for(const Any &any : ints)
+    {
+      total += any.Get<int>();
+    }
+
+    sum = total;
+  }) / anyCount);
+
+  PrintResult("Compare GET_META, mixed", TimeNanoseconds(iterations, [&mixed, &sum]()
+  {
+    int total = 0;
+
+    for(const Any &any : mixed)
+    {
+      if(any.GetMeta() == GET_META(int))
+        total += any.Get<int>();
+    }
+
+    sum = total;
+  }) / anyCount);
+
+  PrintResult("TryGet, mixed", TimeNanoseconds(iterations, [&mixed, &sum]()
+  {
+    int total = 0;
+
+    for(const Any &any : mixed)
+    {
+      if(const int *value = any.TryGet<int>())
+        total += *value;
+    }
+
+    sum = total;
+  }) / anyCount);
+
+  std::cout << std::endl;
+}
+
+// A small object that gets made and thrown away a lot.
+class ChurnObject
+{
+public:
+  double m_Values[6] = {};
+};
+
+CLASS_START(ChurnObject)
+CLASS_END;
+
+// Churn objects on some threads.  Each thread fills a set of live objects, then keeps
+// replacing them.  Prints allocations per second over all the threads, and how much
+// the resident memory grew by the time everything was live.
+template<typename Allocate, typename Free>
+static void TimeChurn(const std::string &name, Allocate allocate, Free free)
+{
+  const unsigned threadCount = 4;
+  const size_t liveCount = 16384;
+  const size_t churnCount = 500000;
+
+  std::atomic<unsigned> finished(0);
+  std::atomic<bool> release(false);
+  std::vector<std::thread> threads;
+
+  size_t residentBefore = GetResidentBytes();
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for(unsigned i = 0; i < threadCount; ++i)
+  {
+    threads.emplace_back([&finished, &release, &allocate, &free]()
+    {
+      std::vector<void *> live(liveCount);
+
+      for(void *&object : live)
+      {
+        object = allocate();
+      }
+
+      for(size_t i = 0; i < churnCount; ++i)
+      {
+        size_t slot = (i * 7919) % liveCount;
+        free(live[slot]);
+        live[slot] = allocate();
+      }
+
+      // Hold on to everything until the memory has been measured.
+      ++finished;
+
+      while(!release)
+      {
+        std::this_thread::yield();
+      }
+
+      for(void *object : live)
+      {
+        free(object);
+      }
+    });
+  }
+
+  while(finished != threadCount)
+  {
+    std::this_thread::yield();
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  size_t residentAfter = GetResidentBytes();
+
+  release = true;
+
+  for(std::thread &thread : threads)
+  {
+    thread.join();
+  }
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+  double allocations = static_cast<double>(threadCount) * (liveCount + churnCount);
+  double grewKB = residentAfter > residentBefore ? (residentAfter - residentBefore) / 1024.0 : 0.0;
+
+  std::cout << name << ": " << allocations / seconds / 1000000.0 << " million allocations per second, "
+            << "resident memory grew " << grewKB << " KB" << std::endl;
+}
+
+static void SlabPoolBenchmark()
+{
+  // Compare making and destroying small objects through the object info (which uses
+  // the type's slab pool) with going straight to the global allocator.  The pool runs
+  // first since it never gives its slabs back, so it can't reuse memory the global
+  // allocator freed.  malloc and free stand in for the global new here so the
+  // allocation counter the tests use doesn't add a shared atomic to every call.
+
+  std::cout << "Benchmark: Slab Pool Churn" << std::endl
+            << "-------------" << std::endl;
+
+  Meta::ObjectInfoBase *objectInfo = GET_META(ChurnObject)->GetObjectInfo();
+
+  if(objectInfo->GetPool() == nullptr)
+  {
+    std::cout << "Slab pools are turned off (META_SLAB_POOLS)" << std::endl << std::endl;
+    return;
+  }
+
+  TimeChurn("Slab pool", [objectInfo]()
+  {
+    return objectInfo->Construct();
+  }, [objectInfo](void *object)
+  {
+    objectInfo->Destroy(object);
+  });
+
+  TimeChurn("Global allocator", []()
+  {
+    return static_cast<void *>(new (std::malloc(sizeof(ChurnObject))) ChurnObject());
+  }, [](void *object)
+  {
+    static_cast<ChurnObject *>(object)->~ChurnObject();
+    std::free(object);
+  });
+
+  std::cout << std::endl;
+}
+
+static void BatchedLifetimeBenchmark()
+{
+  // Compare copying and destroying a big array of plain objects one at a time through 
+  // the object info with the batched calls, which turn into a memcpy and nothing.
+
+  const size_t objectCount = 1000000;
+  const size_t iterations = 20;
+
+  std::cout << "Benchmark: Batched Lifetime" << std::endl
+            << "-------------" << std::endl;
+
+  Meta::ObjectInfoBase *objectInfo = GET_META(ChurnObject)->GetObjectInfo();
+  std::vector<ChurnObject> source(objectCount);
+  std::vector<ChurnObject> destination(objectCount);
+
+  PrintResult("Copy one at a time", TimeNanoseconds(iterations, [objectInfo, &source, &destination]()
+  {
+    for(size_t i = 0; i < objectCount; ++i)
+    {
+      objectInfo->PlacementCopy(&destination[i], &source[i]);
+    }
+
+    s_Sink = destination.data();
+  }) / objectCount);
+
+  PrintResult("CopyN", TimeNanoseconds(iterations, [objectInfo, &source, &destination]()
+  {
+    objectInfo->CopyN(destination.data(), source.data(), objectCount);
+    s_Sink = destination.data();
+  }) / objectCount);
+
+  PrintResult("Destroy one at a time", TimeNanoseconds(iterations, [objectInfo, &destination]()
+  {
+    for(size_t i = 0; i < objectCount; ++i)
+    {
+      objectInfo->Destructor(&destination[i]);
+    }
+
+    s_Sink = destination.data();
+  }) / objectCount);
+
+  PrintResult("DestroyN", TimeNanoseconds(iterations, [objectInfo, &destination]()
+  {
+    objectInfo->DestroyN(destination.data(), objectCount);
+    s_Sink = destination.data();
+  }) / objectCount);
+
+  std::cout << std::endl;
+}
+
+static void LifetimeTableBenchmark()
+{
+  // Compare copying and destroying a string in place through the virtual functions
+  // of the object info with the function pointers kept in the type's Data.
+
+  const size_t iterations = 1000000;
+
+  std::cout << "Benchmark: Lifetime Table" << std::endl
+            << "-------------" << std::endl;
+
+  Meta::Data *data = GET_META(std::string);
+  std::string source = "short";
+  std::aligned_storage<sizeof(std::string), alignof(std::string)>::type buffer;
+
+  PrintResult("ObjectInfo virtual calls", TimeNanoseconds(iterations, [data, &source, &buffer]()
+  {
+    Meta::ObjectInfoBase *objectInfo = data->GetObjectInfo();
+    objectInfo->PlacementCopy(&buffer, &source);
+    objectInfo->Destructor(&buffer);
+    s_Sink = &buffer;
+  }));
+
+  PrintResult("Lifetime table", TimeNanoseconds(iterations, [data, &source, &buffer]()
+  {
+    const Meta::LifetimeTable &lifetime = data->GetLifetime();
+    lifetime.m_Copy(&buffer, &source);
+    lifetime.m_Destroy(&buffer);
+    s_Sink = &buffer;
+  }));
+
+  std::cout << std::endl;
+}
+
+static void AnyVectorBenchmark()
+{
+  // Compare filling and summing a vector of Anys with an AnyVector of the same ints.
+
+  const size_t elementCount = 100000;
+  const size_t iterations = 20;
+
+  std::cout << "Benchmark: AnyVector" << std::endl
+            << "-------------" << std::endl;
+
+  PrintResult("std::vector<Any> fill and sum", TimeNanoseconds(iterations, []()
+  {
+    std::vector<Any> values;
+
+    for(size_t i = 0; i < elementCount; ++i)
+    {
+      values.emplace_back(static_cast<int>(i));
+    }
+
+    size_t total = 0;
+
+    for(const Any &value : values)
+    {
+      total += value.Get<int>();
+    }
+
+    s_Sink = reinterpret_cast<const void *>(total);
+  }) / elementCount);
+
+  PrintResult("AnyVector fill and sum", TimeNanoseconds(iterations, []()
+  {
+    AnyVector values(GET_META(int));
+
+    for(size_t i = 0; i < elementCount; ++i)
+    {
+      values.PushBack(static_cast<int>(i));
+    }
+
+    size_t total = 0;
+
+    for(Any value : values)
+    {
+      total += value.Get<int>();
+    }
+
+    s_Sink = reinterpret_cast<const void *>(total);
+  }) / elementCount);
+
+  std::cout << "Bytes per element: std::vector<Any> " << sizeof(Any) << ", AnyVector " << sizeof(int) << std::endl;
+  std::cout << std::endl;
+}
+
+// An object with a get, a set and a method to time reflective calls on.
+class CallBenchmarkObject
+{
+public:
+  int GetValue() const { return m_Value; }
+  void SetValue(int value) { m_Value = value; }
+  int Add(int value) const { return m_Value + value; }
+
+private:
+  int m_Value = 1;
+};
+
+CLASS_START(CallBenchmarkObject)
+  PROPERTY("Value", GetValue, SetValue);
+CLASS_END;
+
+// How const methods used to be stored, wrapping the method pointer in a std::function.
+class OldAddMethod : public Meta::Method
+{
+public:
+  OldAddMethod(int (CallBenchmarkObject::*func)(int) const)
+    : Meta::Method("Add", GET_META(int), 1, false, true)
+    , m_Function([func](const CallBenchmarkObject &object, int value)
+      {
+        return (object.*func)(value);
+      })
+  {
+    Meta::CaptureArgumentMeta<int>(m_ArgumentMeta);
+  }
+
+  virtual Any Call(void *object, Meta::ArgumentSpan args) const
+  {
+    return Call(static_cast<const void *>(object), args);
+  }
+
+  virtual Any Call(const void *object, Meta::ArgumentSpan args) const
+  {
+    return m_Function(*reinterpret_cast<const CallBenchmarkObject *>(object), args[0]);
+  }
+
+private:
+  std::function<int(const CallBenchmarkObject &, int)> m_Function;
+};
+
+static void AccessorBenchmark()
+{
+  // Compare getters, setters and methods called through std::functions (the old way)
+  // with calling the method pointers directly.  Also count the allocations it takes
+  // to make each, outside of the arena.
+
+  const size_t iterations = 1000000;
+
+  std::cout << "Benchmark: Property and Method Accessors" << std::endl
+            << "-------------" << std::endl;
+
+  size_t allocations = GetAllocationCount();
+
+  int (CallBenchmarkObject::*get)() const = &CallBenchmarkObject::GetValue;
+  void (CallBenchmarkObject::*set)(int) = &CallBenchmarkObject::SetValue;
+
+  Meta::Property *oldProperty = Meta::CreateProperty<CallBenchmarkObject, int, const int &>("Value",
+    [get](const CallBenchmarkObject &object)
+    {
+      return (object.*get)();
+    },
+    [set](CallBenchmarkObject &object, const int &value)
+    {
+      (object.*set)(value);
+    });
+  Meta::Method *oldMethod = Meta::ArenaNew<OldAddMethod>(&CallBenchmarkObject::Add);
+
+  size_t oldAllocations = GetAllocationCount() - allocations;
+  allocations = GetAllocationCount();
+
+  Meta::Property *newProperty = Meta::CreateProperty<CallBenchmarkObject>("Value", &CallBenchmarkObject::GetValue, 
+                                                                          &CallBenchmarkObject::SetValue);
+  Meta::Method *newMethod = Meta::CreateMethod<CallBenchmarkObject>("Add", &CallBenchmarkObject::Add);
+
+  size_t newAllocations = GetAllocationCount() - allocations;
+
+  CallBenchmarkObject object;
+  const int value = 5;
+  std::vector<Any> args = {Any::AnyRef(value)};
+
+  PrintResult("Old Get", TimeNanoseconds(iterations, [oldProperty, &object]()
+  {
+    s_Sink = oldProperty->Get(object).GetInternal();
+  }));
+
+  PrintResult("New Get", TimeNanoseconds(iterations, [newProperty, &object]()
+  {
+    s_Sink = newProperty->Get(object).GetInternal();
+  }));
+
+  PrintResult("Old Set", TimeNanoseconds(iterations, [oldProperty, &object, &value]()
+  {
+    oldProperty->Set(object, value);
+  }));
+
+  PrintResult("New Set", TimeNanoseconds(iterations, [newProperty, &object, &value]()
+  {
+    newProperty->Set(object, value);
+  }));
+
+  PrintResult("Old Call", TimeNanoseconds(iterations, [oldMethod, &object, &args]()
+  {
+    s_Sink = oldMethod->Call(static_cast<const void *>(&object), args).GetInternal();
+  }));
+
+  PrintResult("New Call", TimeNanoseconds(iterations, [newMethod, &object, &args]()
+  {
+    s_Sink = newMethod->Call(static_cast<const void *>(&object), args).GetInternal();
+  }));
+
+  std::cout << "Allocations to create: old " << oldAllocations << ", new " << newAllocations << std::endl;
+  std::cout << std::endl;
+}
+
+static void PropertyHandleBenchmark()
+{
+  // Compare reading and writing through a property, which boxes the value in an Any,
+  // with a handle bound to the same property.
+
+  const size_t iterations = 1000000;
+
+  std::cout << "Benchmark: Property Handles" << std::endl
+            << "-------------" << std::endl;
+
+  PropertyBenchmarkObject object;
+  CallBenchmarkObject callObject;
+
+  Meta::Property *intProperty = GET_META(PropertyBenchmarkObject)->GetProperty("m_Int");
+  Meta::Property *stringProperty = GET_META(PropertyBenchmarkObject)->GetProperty("m_String");
+  Meta::Property *getterProperty = GET_META(CallBenchmarkObject)->GetProperty("Value");
+
+  Meta::PropertyHandle<PropertyBenchmarkObject, int> intHandle(intProperty);
+  Meta::PropertyHandle<PropertyBenchmarkObject, std::string> stringHandle(stringProperty);
+  Meta::PropertyHandle<CallBenchmarkObject, int> getterHandle(getterProperty);
+
+  volatile int sum = 0;
+  volatile size_t length = 0;
+
+  PrintResult("Property Get, m_Int", TimeNanoseconds(iterations, [intProperty, &object, &sum]()
+  {
+    sum = sum + intProperty->Get(object).Get<int>();
+  }));
+
+  PrintResult("Handle Get, m_Int", TimeNanoseconds(iterations, [&intHandle, &object, &sum]()
+  {
+    sum = sum + intHandle.Get(object);
+  }));
+
+  PrintResult("Property Set, m_Int", TimeNanoseconds(iterations, [intProperty, &object]()
+  {
+    intProperty->Set(object, 5);
+  }));
+
+  PrintResult("Handle Set, m_Int", TimeNanoseconds(iterations, [&intHandle, &object]()
+  {
+    intHandle.Set(object, 5);
+  }));
+
+  PrintResult("Property Get, m_String", TimeNanoseconds(iterations, [stringProperty, &object, &length]()
+  {
+    length = stringProperty->Get(object).Get<std::string>().size();
+  }));
+
+  PrintResult("Handle Get, m_String", TimeNanoseconds(iterations, [&stringHandle, &object, &length]()
+  {
+    length = stringHandle.Get(object).size();
+  }));
+
+  PrintResult("Property Get, getter", TimeNanoseconds(iterations, [getterProperty, &callObject, &sum]()
+  {
+    sum = sum + getterProperty->Get(callObject).Get<int>();
+  }));
+
+  PrintResult("Handle Get, getter", TimeNanoseconds(iterations, [&getterHandle, &callObject, &sum]()
+  {
+    sum = sum + getterHandle.Get(callObject);
+  }));
+
+  std::cout << std::endl;
+}
+
+static void PropertyRefBenchmark()
+{
+  // Compare reading every property of an object the way an inspector would, copying
+  // each one into an Any, with referencing the members in place.
+
+  const size_t iterations = 1000000;
+
+  std::cout << "Benchmark: Property References" << std::endl
+            << "-------------" << std::endl;
+
+  PropertyBenchmarkObject object;
+  const Meta::OrderedVector &properties = GET_META(PropertyBenchmarkObject)->GetOrderedData();
+
+  PrintResult("Get every property", TimeNanoseconds(iterations, [&properties, &object]()
+  {
+    for(Meta::DataInfo *dataInfo : properties)
+    {
+      s_Sink = static_cast<Meta::Property *>(dataInfo)->Get(object).GetInternal();
+    }
+  }));
+
+  PrintResult("GetRef every property", TimeNanoseconds(iterations, [&properties, &object]()
+  {
+    for(Meta::DataInfo *dataInfo : properties)
+    {
+      s_Sink = static_cast<Meta::Property *>(dataInfo)->GetRef(object).GetInternal();
+    }
+  }));
+
+  std::cout << std::endl;
+}
+
+class ColumnBenchmarkObject
+{
+public:
+  int m_Int = 1;
+  float m_Float = 2.0f;
+  double m_Double = 3.0;
+};
+
+CLASS_START(ColumnBenchmarkObject)
+  MEMBER(m_Int);
+  MEMBER(m_Float);
+  MEMBER(m_Double);
+CLASS_END;
+
+// Time reading one member out of every object one at a time, and as a column.
+template<typename MemberType>
+static void TimeColumn(const std::string &name, std::vector<ColumnBenchmarkObject> &objects)
+{
+  Meta::Property *property = GET_META(ColumnBenchmarkObject)->GetProperty(name);
+  Meta::PropertyHandle<ColumnBenchmarkObject, MemberType> handle(property);
+  std::vector<MemberType> column(objects.size());
+  size_t count = objects.size();
+
+  PrintResult("Property Get, " + name, TimeNanoseconds(1, [property, &objects, &column, count]()
+  {
+    for(size_t i = 0; i < count; ++i)
+    {
+      column[i] = property->Get(objects[i]).Get<MemberType>();
+    }
+  }) / count);
+
+  PrintResult("Handle Get, " + name, TimeNanoseconds(1, [&handle, &objects, &column, count]()
+  {
+    for(size_t i = 0; i < count; ++i)
+    {
+      column[i] = handle.Get(objects[i]);
+    }
+  }) / count);
+
+  PrintResult("Gather, " + name, TimeNanoseconds(1, [property, &objects, &column, count]()
+  {
+    property->Gather(objects.data(), count, column.data());
+  }) / count);
+
+  PrintResult("Scatter, " + name, TimeNanoseconds(1, [property, &objects, &column, count]()
+  {
+    property->Scatter(objects.data(), count, column.data());
+  }) / count);
+
+  s_Sink = column.data();
+}
+
+static void GatherBenchmark()
+{
+  // Compare pulling one member out of many objects one property call at a time with
+  // gathering the whole column in one call.  Times are per object.
+
+  const size_t count = 10000000;
+
+  std::cout << "Benchmark: Gather/Scatter (10M objects)" << std::endl
+            << "-------------" << std::endl;
+
+  std::vector<ColumnBenchmarkObject> objects(count);
+
+  TimeColumn<int>("m_Int", objects);
+  TimeColumn<float>("m_Float", objects);
+  TimeColumn<double>("m_Double", objects);
+
+  std::cout << std::endl;
+}
+
+// An object like one that gets replicated, mostly plain members with a few that aren't.
+class DiffBenchmarkObject
+{
+public:
+  int m_Id = 0;
+  int m_Health = 100;
+  int m_Armor = 50;
+  int m_Team = 1;
+  float m_X = 0.0f;
+  float m_Y = 0.0f;
+  float m_Z = 0.0f;
+  unsigned m_Flags = 0;
+  unsigned short m_Level = 1;
+  unsigned short m_Ammo = 30;
+  std::string m_Name = "A name too long for the small string buffer";
+};
+
+CLASS_START(DiffBenchmarkObject)
+  MEMBER(m_Id);
+  MEMBER(m_Health);
+  MEMBER(m_Armor);
+  MEMBER(m_Team);
+  MEMBER(m_X);
+  MEMBER(m_Y);
+  MEMBER(m_Z);
+  MEMBER(m_Flags);
+  MEMBER(m_Level);
+  MEMBER(m_Ammo);
+  MEMBER(m_Name);
+CLASS_END;
+
+static void DiffBenchmark()
+{
+  // Compare finding the changed properties of many objects by calling Compare on every
+  // property with Meta::Diff, which checks runs of plain members with one memcmp.
+  // About one object in sixteen has a change.  Times are per object.
+
+  const size_t count = 100000;
+
+  std::cout << "Benchmark: Diff (100K objects)" << std::endl
+            << "-------------" << std::endl;
+
+  Meta::Data *meta = GET_META(DiffBenchmarkObject);
+  const Meta::OrderedVector &properties = meta->GetOrderedData();
+  std::vector<DiffBenchmarkObject> previous(count);
+  std::vector<DiffBenchmarkObject> current(count);
+
+  for(size_t i = 0; i < count; i += 16)
+  {
+    current[i].m_Health = 90;
+  }
+
+  std::vector<bool> changed(properties.size());
+
+  PrintResult("Compare every property", TimeNanoseconds(1, [&properties, &previous, &current, &changed, count]()
+  {
+    for(size_t i = 0; i < count; ++i)
+    {
+      for(size_t j = 0; j < properties.size(); ++j)
+      {
+        changed[j] = !properties[j]->Compare(&previous[i], &current[i]);
+      }
+    }
+  }) / count);
+
+  Meta::PropertyMask mask;
+
+  PrintResult("Diff", TimeNanoseconds(1, [meta, &previous, &current, &mask, count]()
+  {
+    for(size_t i = 0; i < count; ++i)
+    {
+      Meta::Diff(meta, &previous[i], &current[i], mask);
+    }
+  }) / count);
+
+  s_Sink = mask.GetWords().data();
+
+  std::cout << std::endl;
+}
+
+// An object used as a key, with a hand written hash to compare the reflected one to.
+class HashBenchmarkObject
+{
+public:
+  int m_Id = 0;
+  int m_Kind = 1;
+  int m_Width = 2;
+  int m_Height = 3;
+  unsigned m_Flags = 4;
+  unsigned m_Mask = 5;
+  float m_Scale = 1.0f;
+  std::string m_Name = "Name";
+};
+
+CLASS_START(HashBenchmarkObject)
+  MEMBER(m_Id).EnableSerialization();
+  MEMBER(m_Kind).EnableSerialization();
+  MEMBER(m_Width).EnableSerialization();
+  MEMBER(m_Height).EnableSerialization();
+  MEMBER(m_Flags).EnableSerialization();
+  MEMBER(m_Mask).EnableSerialization();
+  MEMBER(m_Scale).EnableSerialization();
+  MEMBER(m_Name).EnableSerialization();
+CLASS_END;
+
+// Combine a hash into a seed the way hash functions usually get written by hand.
+static void HashCombine(size_t &seed, size_t hash)
+{
+  seed ^= hash + 0x9E3779B9 + (seed << 6) + (seed >> 2);
+}
+
+// How the hash for the object would be written by hand.
+static size_t HandWrittenHash(const HashBenchmarkObject &object)
+{
+  size_t seed = 0;
+  HashCombine(seed, std::hash<int>()(object.m_Id));
+  HashCombine(seed, std::hash<int>()(object.m_Kind));
+  HashCombine(seed, std::hash<int>()(object.m_Width));
+  HashCombine(seed, std::hash<int>()(object.m_Height));
+  HashCombine(seed, std::hash<unsigned>()(object.m_Flags));
+  HashCombine(seed, std::hash<unsigned>()(object.m_Mask));
+  HashCombine(seed, std::hash<float>()(object.m_Scale));
+  HashCombine(seed, std::hash<std::string>()(object.m_Name));
+  return seed;
+}
+
+static void HashBenchmark()
+{
+  // Compare hashing objects with a hand written hash to the reflected hash, which
+  // hashes the six ints as one range of bytes.  Times are per object.
+
+  const size_t count = 1000000;
+
+  std::cout << "Benchmark: Hash (1M objects)" << std::endl
+            << "-------------" << std::endl;
+
+  std::vector<HashBenchmarkObject> objects(count);
+
+  for(size_t i = 0; i < count; ++i)
+  {
+    objects[i].m_Id = static_cast<int>(i);
+  }
+
+  size_t total = 0;
+
+  PrintResult("Hand written hash", TimeNanoseconds(1, [&objects, &total, count]()
+  {
+    for(size_t i = 0; i < count; ++i)
+    {
+      total += HandWrittenHash(objects[i]);
+    }
+  }) / count);
+
+  Meta::Data *meta = GET_META(HashBenchmarkObject);
+
+  PrintResult("Meta::Hash", TimeNanoseconds(1, [meta, &objects, &total, count]()
+  {
+    for(size_t i = 0; i < count; ++i)
+    {
+      total += Meta::Hash(meta, &objects[i]);
+    }
+  }) / count);
+
+  std::vector<Any> anys(objects.begin(), objects.begin() + count / 10);
+
+  PrintResult("Any::Hash", TimeNanoseconds(1, [&anys, &total]()
+  {
+    for(const Any &any : anys)
+    {
+      total += any.Hash();
+    }
+  }) / anys.size());
+
+  s_Sink = reinterpret_cast<const void *>(total);
+
+  std::cout << std::endl;
+}
+
+// A class with a lot of overloads of one method, like a math library has.
+class OverloadBenchmarkObject
+{
+public:
+  template<typename A>
+  int Pick(A) const { return 1; }
+  template<typename A, typename B>
+  int Pick(A, B) const { return 2; }
+};
+
+// The types the overloads take.
+typedef Meta::TypeList<int, unsigned int, short, unsigned short, char, float, double, bool> OverloadTypes;
+
+// Add the overload of Pick taking the given arguments.
+template<typename ...Args>
+static void AddPick(Meta::Data *data, const std::string &name)
+{
+  typedef OverloadBenchmarkObject T;
+  typedef int (T::*Function)(Args...) const;
+
+  data->AddMethod(Meta::CreateMethod<T>(name, static_cast<Function>(&T::Pick)));
+}
+
+// Add an overload taking each type, after the given arguments.
+template<typename ...First, typename ...Types>
+static void AddPicks(Meta::Data *data, const std::string &name, Meta::TypeList<Types...>)
+{
+  int expand[] = {0, (AddPick<First..., Types>(data, name), 0)...};
+  (void)expand;
+}
+
+CLASS_START(OverloadBenchmarkObject)
+  AddPick<int>(data, "Pick1");
+
+  AddPicks<>(data, "Pick8", OverloadTypes());
+
+  AddPicks<>(data, "Pick32", OverloadTypes());
+  AddPicks<int>(data, "Pick32", OverloadTypes());
+  AddPicks<float>(data, "Pick32", OverloadTypes());
+  AddPicks<double>(data, "Pick32", OverloadTypes());
+CLASS_END;
+
+// How overloads used to be found, checking every one of them in order.
+static Meta::Method *FindMethodLinear(const std::vector<Meta::Method *> &methods,
+                                      const std::vector<Any> &args, bool isConst)
+{
+  Meta::Method *constMethod = nullptr;
+
+  for(Meta::Method *method : methods)
+  {
+    if(method->GetArgNum() != args.size())
+      continue;
+
+    bool isSame = true;
+
+    for(size_t i = 0; i < args.size() && isSame; ++i)
+    {
+      isSame = args[i].GetMeta() == method->GetArguments()[i];
+    }
+
+    if(!isSame)
+      continue;
+
+    if(method->IsConst() == isConst)
+      return method;
+    else if(!isConst)
+      constMethod = method;
+  }
+
+  return constMethod;
+}
+
+// Time finding and calling the last overload added, the worst case for a linear search.
+static void TimeOverloads(const std::string &name, const std::vector<Any> &args)
+{
+  const size_t iterations = 1000000;
+
+  OverloadBenchmarkObject object;
+  const Meta::MethodOverloads *overloads = GET_META(OverloadBenchmarkObject)->GetMethod(name);
+  const std::vector<Meta::Method *> &methods = overloads->GetMethods();
+  std::vector<Meta::Data *> argMeta;
+
+  for(const Any &arg : args)
+  {
+    argMeta.push_back(arg.GetMeta());
+  }
+
+  std::string count = std::to_string(methods.size()) + " overloads";
+
+  PrintResult("Linear search, " + count, TimeNanoseconds(iterations, [&methods, &args]()
+  {
+    s_Sink = FindMethodLinear(methods, args, true);
+  }));
+
+  PrintResult("FindMethod, " + count, TimeNanoseconds(iterations, [overloads, &argMeta]()
+  {
+    s_Sink = overloads->FindMethod(argMeta, true);
+  }));
+
+  PrintResult("Call, " + count, TimeNanoseconds(iterations, [overloads, &object, &args]()
+  {
+    s_Sink = overloads->Call(static_cast<const void *>(&object), args).GetInternal();
+  }));
+}
+
+static void OverloadBenchmark()
+{
+  // Compare finding an overload by checking every overload (how MethodOverloads used
+  // to do it) with the signature tables, and time a whole call through the overloads.
+
+  std::cout << "Benchmark: Overload Resolution" << std::endl
+            << "-------------" << std::endl;
+
+  TimeOverloads("Pick1", {Any(1)});
+  TimeOverloads("Pick8", {Any(true)});
+  TimeOverloads("Pick32", {Any(1.0), Any(true)});
+
+  std::cout << std::endl;
+}
+
+static void ArgumentBenchmark()
+{
+  // Compare calling with the arguments put in a std::vector (how the variadic calls
+  // used to pass them) with the arguments in an array on the stack, and count the
+  // allocations each one makes.
+
+  const size_t iterations = 1000000;
+
+  std::cout << "Benchmark: Call Arguments" << std::endl
+            << "-------------" << std::endl;
+
+  OverloadBenchmarkObject object;
+  const Meta::MethodOverloads *overloads = GET_META(OverloadBenchmarkObject)->GetMethod("Pick32");
+  const double first = 1.0;
+  const bool second = true;
+
+  size_t allocations = GetAllocationCount();
+
+  PrintResult("Vector arguments", TimeNanoseconds(iterations, [overloads, &object, &first, &second]()
+  {
+    std::vector<Any> args = {Any::AnyRef(first), Any::AnyRef(second)};
+    s_Sink = overloads->Call(static_cast<const void *>(&object), args).GetInternal();
+  }));
+
+  size_t vectorAllocations = GetAllocationCount() - allocations;
+  allocations = GetAllocationCount();
+
+  PrintResult("Stack arguments", TimeNanoseconds(iterations, [overloads, &object, first, second]()
+  {
+    s_Sink = overloads->Call(object, first, second).GetInternal();
+  }));
+
+  size_t stackAllocations = GetAllocationCount() - allocations;
+
+  std::cout << "Allocations per call: vector " << vectorAllocations / iterations 
+            << ", stack " << stackAllocations / iterations << std::endl;
+  std::cout << std::endl;
+}
+
+static void MethodHandleBenchmark()
+{
+  // Compare calling an overload by name through the overloads, which finds it and
+  // boxes the arguments and return in Anys, with a handle bound to it once.
+
+  const size_t iterations = 1000000;
+
+  std::cout << "Benchmark: Method Handles" << std::endl
+            << "-------------" << std::endl;
+
+  OverloadBenchmarkObject object;
+  const Meta::MethodOverloads *overloads = GET_META(OverloadBenchmarkObject)->GetMethod("Pick32");
+  Meta::MethodHandle<int(const OverloadBenchmarkObject &, double, bool)> handle("Pick32");
+  const double first = 1.0;
+  const bool second = true;
+  int total = 0;
+
+  PrintResult("MethodOverloads::Call", TimeNanoseconds(iterations, [overloads, &object, first, second]()
+  {
+    s_Sink = overloads->Call(object, first, second).GetInternal();
+  }));
+
+  PrintResult("MethodHandle::Call", TimeNanoseconds(iterations, [&handle, &object, &total, first, second]()
+  {
+    total += handle.Call(object, first, second);
+  }));
+
+  s_Sink = reinterpret_cast<const void *>(static_cast<size_t>(total));
+
+  std::cout << std::endl;
+}
+
+void RunBenchmarks()
+{
+  NameLookupBenchmark();
+  IsABenchmark();
+  RegistryStressBenchmark();
+  LazyRegistrationBenchmark();
+  PropertyBenchmark();
+  TypedAccessBenchmark();
+  SlabPoolBenchmark();
+  BatchedLifetimeBenchmark();
+  LifetimeTableBenchmark();
+  AnyVectorBenchmark();
+  AccessorBenchmark();
+  PropertyHandleBenchmark();
+  PropertyRefBenchmark();
+  GatherBenchmark();
+  DiffBenchmark();
+  HashBenchmark();
+  OverloadBenchmark();
+  ArgumentBenchmark();
+  MethodHandleBenchmark();
+}
@@ -0,0 +1,8 @@
+/*****************************************************************************
+File:   Benchmark.h
+Author: Alex Troyer
+  Times the hot paths of the meta system so changes to them can be measured.
+*****************************************************************************/
+#pragma once
+
+void RunBenchmarks();
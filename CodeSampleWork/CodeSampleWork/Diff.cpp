@@ -0,0 +1,125 @@
+/*****************************************************************************
+File:   Diff.cpp
+Author: Alex Troyer
+  Compares two objects of the same type property by property, giving back
+  which of their properties are different.
+*****************************************************************************/
+#include "Diff.h"
+#include "Property.h"
+#include <cstring>
+
+namespace Meta
+{
+  // Make a mask for the given number of properties with no bits set.
+  PropertyMask::PropertyMask(size_t count)
+  {
+    Reset(count);
+  }
+
+  // Clear every bit and resize the mask for the given number of properties.  The
+  // memory is kept, so reusing a mask for objects of the same type doesn't allocate.
+  void PropertyMask::Reset(size_t count)
+  {
+    m_Words.assign((count + BitsPerWord - 1) / BitsPerWord, 0);
+    m_Count = count;
+  }
+
+  // Whether or not no bits are set.
+  bool PropertyMask::IsEmpty() const
+  {
+    for(uint64_t word : m_Words)
+    {
+      if(word != 0)
+        return false;
+    }
+
+    return true;
+  }
+
+  // Get how many properties the mask has a bit for.
+  size_t PropertyMask::GetCount() const
+  {
+    return m_Count;
+  }
+
+  // Get how many bits are set.
+  size_t PropertyMask::GetSetCount() const
+  {
+    size_t count = 0;
+
+    for(uint64_t word : m_Words)
+    {
+      // Clear the lowest set bit until there are none left.
+      for(; word != 0; word &= word - 1)
+      {
+        ++count;
+      }
+    }
+
+    return count;
+  }
+
+  // Get the bits, 64 properties to a word, with the first property in the lowest bit.
+  const std::vector<uint64_t> &PropertyMask::GetWords() const
+  {
+    return m_Words;
+  }
+
+  // Find which properties are different between two objects of the given type.
+  PropertyMask Diff(const Data *data, const void *lhs, const void *rhs)
+  {
+    PropertyMask mask;
+    Diff(data, lhs, rhs, mask);
+
+    return mask;
+  }
+
+  // Find which properties are different between two objects of the given type,
+  // setting the bit for each one in the mask (bits are by index in the ordered data).
+  // Runs of plain members next to each other are checked with one memcmp, and only
+  // looked at one by one if that finds a difference.  Everything else goes through
+  // the property's Compare, which compares members in place instead of copying them.
+  // Static properties are the same for every object, so their bits are never set.
+  void Diff(const Data *data, const void *lhs, const void *rhs, PropertyMask &mask)
+  {
+    const OrderedVector &orderedData = data->GetOrderedData();
+
+    mask.Reset(orderedData.size());
+
+    // The spans are only stored once the type is frozen.
+    PropertySpanVector unfrozenSpans;
+    const PropertySpanVector *spans = &data->GetPropertySpans();
+
+    if(!data->IsFrozen())
+    {
+      BuildPropertySpans(data, unfrozenSpans, false);
+      spans = &unfrozenSpans;
+    }
+
+    const char *left = reinterpret_cast<const char *>(lhs);
+    const char *right = reinterpret_cast<const char *>(rhs);
+
+    for(const PropertySpan &span : *spans)
+    {
+      if(span.m_Size == 0)
+      {
+        if(!orderedData[span.m_First]->Compare(lhs, rhs))
+          mask.Set(span.m_First);
+
+        continue;
+      }
+
+      if(std::memcmp(left + span.m_Offset, right + span.m_Offset, span.m_Size) == 0)
+        continue;
+
+      for(size_t i = span.m_First; i < span.m_First + span.m_Count; ++i)
+      {
+        const Property *prop = static_cast<const Property *>(orderedData[i]);
+        size_t offset = prop->GetOffset();
+
+        if(std::memcmp(left + offset, right + offset, prop->GetValueSize()) != 0)
+          mask.Set(i);
+      }
+    }
+  }
+}
@@ -0,0 +1,48 @@
+/*****************************************************************************
+File:   Diff.h
+Author: Alex Troyer
+  Compares two objects of the same type property by property, giving back
+  which of their properties are different.
+*****************************************************************************/
+#pragma once
+
+#include "Meta.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Meta
+{
+  // One bit for each property in a type's ordered data (in the order they were
+  // registered), set when the property is different between two objects.
+  class PropertyMask
+  {
+  public:
+    static const size_t BitsPerWord = 64;
+
+    PropertyMask() = default;
+    explicit PropertyMask(size_t count);
+
+    void Reset(size_t count);
+
+    void Set(size_t index);
+    bool Test(size_t index) const;
+    bool IsEmpty() const;
+    size_t GetCount() const;
+    size_t GetSetCount() const;
+
+    const std::vector<uint64_t> &GetWords() const;
+
+  private:
+    std::vector<uint64_t> m_Words;
+    size_t m_Count = 0;
+  };
+
+  PropertyMask Diff(const Data *data, const void *lhs, const void *rhs);
+  void Diff(const Data *data, const void *lhs, const void *rhs, PropertyMask &mask);
+
+  template<typename T>
+  PropertyMask Diff(const T &lhs, const T &rhs);
+}
+
+#include "Diff.hpp"
@@ -0,0 +1,29 @@
+/*****************************************************************************
+File:   Diff.hpp
+Author: Alex Troyer
+  Compares two objects of the same type property by property, giving back
+  which of their properties are different.
+*****************************************************************************/
+#pragma once
+
+namespace Meta
+{
+  // Set the bit for a property.
+  inline void PropertyMask::Set(size_t index)
+  {
+    m_Words[index / BitsPerWord] |= uint64_t(1) << (index % BitsPerWord);
+  }
+
+  // Check the bit for a property.
+  inline bool PropertyMask::Test(size_t index) const
+  {
+    return (m_Words[index / BitsPerWord] & (uint64_t(1) << (index % BitsPerWord))) != 0;
+  }
+
+  // Diff two objects whose type is known at compile time.
+  template<typename T>
+  PropertyMask Diff(const T &lhs, const T &rhs)
+  {
+    return Diff(GET_META(T), static_cast<const void *>(&lhs), static_cast<const void *>(&rhs));
+  }
+}
@@ -0,0 +1,95 @@
+/*****************************************************************************
+File:   Hash.cpp
+Author: Alex Troyer
+  Hashes registered objects from their serialized properties, so classes
+  don't need a hand written hash to be used as keys.
+*****************************************************************************/
+#include "Hash.h"
+#include "Property.h"
+#include <cstdint>
+#include <cstring>
+
+namespace Meta
+{
+  // Read up to 8 bytes as a word.
+  static std::uint64_t ReadBytes(const char *bytes, size_t length)
+  {
+    std::uint64_t word = 0;
+    std::memcpy(&word, bytes, length);
+
+    return word;
+  }
+
+  // Mix bytes into a hash a word at a time, the same way names are hashed.
+  static std::uint64_t MixBytes(const char *bytes, size_t length, std::uint64_t hash)
+  {
+    while(length > 8)
+    {
+      hash = (hash ^ ReadBytes(bytes, 8)) * HashMultiplier;
+      bytes += 8;
+      length -= 8;
+    }
+
+    return (hash ^ ReadBytes(bytes, length)) * HashMultiplier;
+  }
+
+  // Hash a range of bytes.
+  size_t HashBytes(const void *bytes, size_t length)
+  {
+    return static_cast<size_t>(FinalizeHash(MixBytes(reinterpret_cast<const char *>(bytes), length, HashSeed ^ length)));
+  }
+
+  // Hash an object from its serialized properties, in the order they were registered.
+  // Runs of plain members next to each other are hashed as one range of bytes, and
+  // every other property hashes its value.  Only members whose bytes are equal exactly
+  // when their values are get hashed as bytes, so equal objects always hash the same.
+  size_t Hash(const Data *data, const void *object)
+  {
+    // The spans are only stored once the type is frozen.
+    PropertySpanVector unfrozenSpans;
+    const PropertySpanVector *spans = &data->GetSerializedPropertySpans();
+
+    if(!data->IsFrozen())
+    {
+      BuildPropertySpans(data, unfrozenSpans, true);
+      spans = &unfrozenSpans;
+    }
+
+    const OrderedVector &orderedData = data->GetOrderedData();
+    const char *bytes = reinterpret_cast<const char *>(object);
+    std::uint64_t hash = HashSeed;
+
+    for(const PropertySpan &span : *spans)
+    {
+      if(span.m_Size != 0)
+      {
+        hash = MixBytes(bytes + span.m_Offset, span.m_Size, hash);
+      }
+      else
+      {
+        Property *prop = static_cast<Property *>(orderedData[span.m_First]);
+        hash = (hash ^ prop->Hash(object)) * HashMultiplier;
+      }
+    }
+
+    return static_cast<size_t>(FinalizeHash(hash));
+  }
+
+  // Hash a value of any registered type.  Its std::hash is used if it has one,
+  // otherwise it is hashed from its properties.  A type that was never registered
+  // has nothing to hash.
+  size_t HashValue(Data *valueMeta, const void *value)
+  {
+    const ObjectInfoBase *objectInfo = valueMeta->GetObjectInfo();
+
+    if(objectInfo == nullptr)
+      return 0;
+
+    if(objectInfo->HasHash())
+      return objectInfo->Hash(value);
+
+    valueMeta->EnsureBuilt();
+
+    return Hash(valueMeta, value);
+  }
+}
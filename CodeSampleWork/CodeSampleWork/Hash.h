@@ -0,0 +1,32 @@
+/*****************************************************************************
+File:   Hash.h
+Author: Alex Troyer
+  Hashes registered objects from their serialized properties, so classes
+  don't need a hand written hash to be used as keys.
+*****************************************************************************/
+#pragma once
+
+#include "Meta.h"
+#include <cstddef>
+
+namespace Meta
+{
+  size_t Hash(const Data *data, const void *object);
+  size_t HashValue(Data *valueMeta, const void *value);
+  size_t HashBytes(const void *bytes, size_t length);
+
+  template<typename T>
+  size_t Hash(const T &object);
+
+  // Hashes a registered class through its meta data.  This can be given to hashed
+  // containers in place of std::hash, like std::unordered_set<T, Meta::ReflectedHash<T>>.
+  // The class still needs an == that agrees with it (equal objects have equal
+  // serialized properties).
+  template<typename T>
+  struct ReflectedHash
+  {
+    size_t operator()(const T &object) const;
+  };
+}
+
+#include "Hash.hpp"
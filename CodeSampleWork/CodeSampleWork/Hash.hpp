@@ -0,0 +1,23 @@
+/*****************************************************************************
+File:   Hash.hpp
+Author: Alex Troyer
+  Hashes registered objects from their serialized properties, so classes
+  don't need a hand written hash to be used as keys.
+*****************************************************************************/
+#pragma once
+
+namespace Meta
+{
+  // Hash an object whose type is known at compile time.
+  template<typename T>
+  size_t Hash(const T &object)
+  {
+    return Hash(GET_META(T), static_cast<const void *>(&object));
+  }
+
+  template<typename T>
+  size_t ReflectedHash<T>::operator()(const T &object) const
+  {
+    return Meta::Hash(object);
+  }
+}
@@ -4,22 +4,40 @@ Author: Alex Troyer
   Where main lives.
 *****************************************************************************/
 #include "Meta.h"
+#include "TestMeta.h"
 #include "TestObjectInfo.h"
 #include "TestAny.h"
 #include "TestProperty.h"
 #include "TestMethod.h"
 #include "TestSerializer.h"
+#include "Benchmark.h"
 #include <iostream>
+#include <cstring>
 
-int main()
+int main(int argc, char *argv[])
 {
+  // Static registration is done, so lock the meta data down.
+  Meta::Freeze();
+
   // Run all the tests for the meta system.
+  TestMeta();
   TestObjectInfo();
   TestAny();
   TestProperty();
   TestMethod();
   TestSerializer();
 
+  // Time the hot paths of the meta system, only when asked to with "--benchmark" since
+  // they take a lot longer than the tests.
+  for(int i = 1; i < argc; ++i)
+  {
+    if(std::strcmp(argv[i], "--benchmark") == 0)
+    {
+      RunBenchmarks();
+      break;
+    }
+  }
+
   std::getchar();
 
   return 0;
@@ -0,0 +1,123 @@
+/*****************************************************************************
+File:   MemoryResource.cpp
+Author: Alex Troyer
+  Lets a caller decide where the objects the meta system makes get their
+  memory from.  This works like std::pmr::memory_resource, which isn't
+  available until C++17.
+*****************************************************************************/
+#include "MemoryResource.h"
+#include <cstdint>
+#include <new>
+
+namespace Meta
+{
+  // The resource set by the innermost ResourceScope on this thread.
+  static thread_local MemoryResource *t_ScopedResource = nullptr;
+
+  // Start out empty.  The first allocation gets a block.
+  MonotonicResource::MonotonicResource(size_t blockSize)
+    : m_BlockSize(blockSize)
+  {
+  }
+
+  // Start out handing out the caller's buffer.  The buffer isn't owned, so it is just
+  // reused after a Release.
+  MonotonicResource::MonotonicResource(void *buffer, size_t size, size_t blockSize)
+    : m_Buffer(static_cast<char *>(buffer))
+    , m_BufferSize(size)
+    , m_BlockSize(blockSize)
+    , m_Current(static_cast<char *>(buffer))
+    , m_End(static_cast<char *>(buffer) + size)
+  {
+  }
+
+  MonotonicResource::~MonotonicResource()
+  {
+    Release();
+  }
+
+  // Bump the pointer, starting a new block if this doesn't fit in what is left of the
+  // current one.  Anything bigger than a block gets a block of its own.
+  void *MonotonicResource::Allocate(size_t size, size_t alignment)
+  {
+    std::uintptr_t current = reinterpret_cast<std::uintptr_t>(m_Current);
+    std::uintptr_t aligned = (current + alignment - 1) & ~(alignment - 1);
+
+    if(m_Current == nullptr || aligned + size > reinterpret_cast<std::uintptr_t>(m_End))
+    {
+      size_t needed = sizeof(BlockHeader) + size + alignment;
+      size_t blockSize = needed > m_BlockSize ? needed : m_BlockSize;
+
+      BlockHeader *block = static_cast<BlockHeader *>(::operator new(blockSize));
+      block->m_Next = m_Blocks;
+      m_Blocks = block;
+      ++m_BlockCount;
+
+      m_Current = reinterpret_cast<char *>(block + 1);
+      m_End = reinterpret_cast<char *>(block) + blockSize;
+
+      current = reinterpret_cast<std::uintptr_t>(m_Current);
+      aligned = (current + alignment - 1) & ~(alignment - 1);
+    }
+
+    m_Current = reinterpret_cast<char *>(aligned + size);
+    m_BytesUsed += size;
+
+    return reinterpret_cast<void *>(aligned);
+  }
+
+  // Memory is only given back by Release.
+  void MonotonicResource::Deallocate(void *, size_t, size_t)
+  {
+  }
+
+  // Give back every block at once and start over at the caller's buffer, if there is
+  // one.  Anything still using the memory has to be gone by now.
+  void MonotonicResource::Release()
+  {
+    while(m_Blocks != nullptr)
+    {
+      BlockHeader *next = m_Blocks->m_Next;
+      ::operator delete(m_Blocks);
+      m_Blocks = next;
+    }
+
+    m_Current = m_Buffer;
+    m_End = m_Buffer + m_BufferSize;
+    m_BlockCount = 0;
+    m_BytesUsed = 0;
+  }
+
+  // Get how many blocks have been allocated since the last Release.
+  size_t MonotonicResource::GetBlockCount() const
+  {
+    return m_BlockCount;
+  }
+
+  // Get how many bytes have been handed out since the last Release (not counting 
+  // alignment padding).
+  size_t MonotonicResource::GetBytesUsed() const
+  {
+    return m_BytesUsed;
+  }
+
+  // Use the resource on this thread until the scope ends.
+  ResourceScope::ResourceScope(MemoryResource *resource)
+    : m_Previous(t_ScopedResource)
+  {
+    t_ScopedResource = resource;
+  }
+
+  // Go back to whatever the enclosing scope was using.
+  ResourceScope::~ResourceScope()
+  {
+    t_ScopedResource = m_Previous;
+  }
+
+  // Get the resource objects on this thread should come from, or null if no scope
+  // has set one.
+  MemoryResource *GetScopedResource()
+  {
+    return t_ScopedResource;
+  }
+}
@@ -0,0 +1,85 @@
+/*****************************************************************************
+File:   MemoryResource.h
+Author: Alex Troyer
+  Lets a caller decide where the objects the meta system makes get their
+  memory from.  This works like std::pmr::memory_resource, which isn't
+  available until C++17.
+*****************************************************************************/
+#pragma once
+
+#include <cstddef>
+
+namespace Meta
+{
+  // Somewhere to get memory from.
+  class MemoryResource
+  {
+  public:
+    virtual ~MemoryResource() = default;
+
+    virtual void *Allocate(size_t size, size_t alignment) = 0;
+    virtual void Deallocate(void *ptr, size_t size, size_t alignment) = 0;
+  };
+
+  // Hands out memory by bumping a pointer through blocks, and gives it all back at once
+  // with Release (or when it is destroyed).  Deallocate does nothing, so objects made
+  // in it only need their destructors called.  It can start out with a buffer from the 
+  // caller, like one on the stack, before it allocates any blocks of its own.  This is 
+  // meant to be used by one thread at a time.
+  class MonotonicResource : public MemoryResource
+  {
+  public:
+    static const size_t DefaultBlockSize = 4096;
+
+    explicit MonotonicResource(size_t blockSize = DefaultBlockSize);
+    MonotonicResource(void *buffer, size_t size, size_t blockSize = DefaultBlockSize);
+    ~MonotonicResource();
+
+    MonotonicResource(const MonotonicResource &) = delete;
+    MonotonicResource &operator=(const MonotonicResource &) = delete;
+
+    virtual void *Allocate(size_t size, size_t alignment);
+    virtual void Deallocate(void *ptr, size_t size, size_t alignment);
+
+    void Release();
+
+    size_t GetBlockCount() const;
+    size_t GetBytesUsed() const;
+
+  private:
+    // Blocks are chained together through a header at the front of each one.
+    struct BlockHeader
+    {
+      BlockHeader *m_Next;
+    };
+
+    char *m_Buffer = nullptr;
+    size_t m_BufferSize = 0;
+    size_t m_BlockSize;
+
+    BlockHeader *m_Blocks = nullptr;
+    char *m_Current = nullptr;
+    char *m_End = nullptr;
+    size_t m_BlockCount = 0;
+    size_t m_BytesUsed = 0;
+  };
+
+  // While one of these is around, objects the meta system makes on this thread without 
+  // being told where to go get their memory from the given resource.  This is how the 
+  // values returned from Property::Get and Method::Call end up in a caller's arena.
+  // Scopes nest, and a null resource goes back to the default allocation.
+  class ResourceScope
+  {
+  public:
+    explicit ResourceScope(MemoryResource *resource);
+    ~ResourceScope();
+
+    ResourceScope(const ResourceScope &) = delete;
+    ResourceScope &operator=(const ResourceScope &) = delete;
+
+  private:
+    MemoryResource *m_Previous;
+  };
+
+  MemoryResource *GetScopedResource();
+}
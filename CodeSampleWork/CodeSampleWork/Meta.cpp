@@ -8,37 +8,137 @@ Author: Alex Troyer
 #include "Method.h"
 #include "Property.h"
 #include "Error.h"
+#include <mutex>
 
 namespace Meta
 {
-  // Find meta data by name.
-  Data *NamedMetaStorage::GetMeta(const std::string &name)
+  // Constructed on first use, so it exists no matter which static registration runs first.
+  static std::recursive_mutex &GetRegistryMutex()
   {
-    auto it = m_MetaMap->find(name);
+    static std::recursive_mutex mutex;
+    return mutex;
+  }
 
-    if(it != m_MetaMap->end())
-    {
-      return it->second;
-    }
+  RegistryWriteLock::RegistryWriteLock()
+  {
+    GetRegistryMutex().lock();
+  }
 
-    return nullptr;
+  RegistryWriteLock::~RegistryWriteLock()
+  {
+    GetRegistryMutex().unlock();
+  }
+
+  // Find meta data by name.  This never locks, it just reads whatever snapshot is current.
+  Data *NamedMetaStorage::GetMeta(const HashedName &name)
+  {
+    const NameMap<Data> *metaMap = m_MetaMap.load(std::memory_order_acquire);
+
+    if(!metaMap)
+      return nullptr;
+
+    Data *data = metaMap->Find(name);
+
+    if(data != nullptr)
+      data->EnsureBuilt();
+
+    return data;
   }
 
   // If this wasn't a pointer, we would have a fun issue with static initialization order.
   // Since m_MetaMap is set to nullptr before objects are constructed, we can then
   // say when we want to construct it (which is going to be when we first want to insert
   // into it).
-  std::unordered_map<std::string, Data *> *NamedMetaStorage::m_MetaMap = nullptr;
+  std::atomic<NameMap<Data> *> NamedMetaStorage::m_MetaMap(nullptr);
+  std::vector<NameMap<Data> *> *NamedMetaStorage::m_Retired = nullptr;
 
-  // Add meta data by name.
-  void NamedMetaStorage::AddMetaData(const std::string &name, Data *meta)
+  // Add meta data by its name.  If the name is already taken, the first one added wins.
+  void NamedMetaStorage::AddMetaData(Data *meta)
   {
+    RegistryWriteLock lock;
+
+    NameMap<Data> *metaMap = m_MetaMap.load(std::memory_order_relaxed);
+
     // We want to make sure that the map is constructed before adding anything to it,
     // so construct it now if it doesn't exist.
-    if(!m_MetaMap)
-      m_MetaMap = new std::unordered_map<std::string, Data *>();
+    if(!metaMap)
+    {
+      metaMap = new NameMap<Data>();
+      m_MetaMap.store(metaMap, std::memory_order_release);
+    }
+
+    // Before the registry is frozen we're still in static registration, so nobody else
+    // is reading and the map can be added to in place.
+    if(!IsFrozen())
+    {
+      metaMap->Insert(meta->GetInternedName(), meta);
+      return;
+    }
+
+    // Otherwise other threads could be in the middle of a lookup, so add to a copy and
+    // swap it in.  The old one is kept around until it's safe to delete.
+    NameMap<Data> *snapshot = new NameMap<Data>(*metaMap);
+    snapshot->Insert(meta->GetInternedName(), meta);
+    m_MetaMap.store(snapshot, std::memory_order_release);
+
+    if(!m_Retired)
+      m_Retired = new std::vector<NameMap<Data> *>();
+
+    m_Retired->push_back(metaMap);
+  }
+
+  // Delete the snapshots replaced by runtime registration.  Call this at a point where
+  // no thread can still be in the middle of a name lookup (like between frames, or once
+  // worker threads are joined).
+  void NamedMetaStorage::ReclaimSnapshots()
+  {
+    RegistryWriteLock lock;
+
+    if(!m_Retired)
+      return;
+
+    for(NameMap<Data> *snapshot : *m_Retired)
+    {
+      delete snapshot;
+    }
+
+    m_Retired->clear();
+  }
 
-    m_MetaMap->insert({name, meta});
+  // Like the meta map, these are zero initialized before any constructors run so
+  // registration can happen in any order.
+  Data *TypeTable::m_Blocks[TypeTable::MaxBlocks];
+  std::atomic<TypeId> TypeTable::m_Count(0);
+
+  // Hand out the next record in the table and give it the next id.
+  Data *TypeTable::Reserve()
+  {
+    RegistryWriteLock lock;
+
+    TypeId id = m_Count.load(std::memory_order_relaxed);
+    TypeId block = id / BlockSize;
+
+    FATAL_ERROR_IF(block >= MaxBlocks, "Too many types registered to the meta system!");
+
+    // Allocate a whole block of records at once the first time we step into it.
+    if(m_Blocks[block] == nullptr)
+      m_Blocks[block] = ArenaNewArray<Data>(BlockSize);
+
+    Data *data = &m_Blocks[block][id % BlockSize];
+    data->m_Id = id;
+
+    // Readers can find the record by id from now on.  Its name and object info are
+    // filled in when the type registers, which is later if it's only being reserved
+    // (like for a parent that hasn't registered yet).
+    m_Count.store(id + 1, std::memory_order_release);
+
+    return data;
+  }
+
+  // Get how many types have been registered.
+  TypeId TypeTable::GetCount()
+  {
+    return m_Count.load(std::memory_order_acquire);
   }
 
   // Get the properties in the order they were registered in.
@@ -59,17 +159,34 @@ namespace Meta
     return m_PropertyMap;
   }
 
+  // Get the non-static properties grouped into spans.  This is only filled in once
+  // frozen, before that use BuildPropertySpans.
+  const PropertySpanVector &Data::GetPropertySpans() const
+  {
+    return m_Spans;
+  }
+
+  // Get the non-static properties that are serialized grouped into spans.  This is
+  // also only filled in once frozen.
+  const PropertySpanVector &Data::GetSerializedPropertySpans() const
+  {
+    return m_SerializedSpans;
+  }
+
   // Add a method to the meta data.
   Method &Data::AddMethod(Method *method)
   {
+    FATAL_ERROR_IF(m_IsFrozen, "Adding a method to frozen meta data!\nClass Name: " + GetName() +
+                   "\nMethod Name: " + method->GetName());
+
     auto it = m_MethodMap.find(method->GetName());
 
-    std::shared_ptr<MethodOverloads> methodOverloads;
+    MethodOverloads *methodOverloads;
 
     // If the method doesn't exist yet, make an overload for it.
     if(it == m_MethodMap.end())
     {
-      methodOverloads = std::make_shared<MethodOverloads>();
+      methodOverloads = ArenaNew<MethodOverloads>();
       m_MethodMap.insert({method->GetName(), methodOverloads});
       methodOverloads->m_Owner = this;
     }
@@ -85,17 +202,22 @@ namespace Meta
   }
 
   // Get the method by name.
-  MethodOverloads *Data::GetMethod(const std::string &name)
+  MethodOverloads *Data::GetMethod(const HashedName &name) const
   {
-    auto it = m_MethodMap.find(name);
+    // Once frozen, everything inherited is already in the flat table.
+    if(m_IsFrozen)
+      return m_FlatMethods.Find(name);
+
+    auto it = m_MethodMap.find(std::string(name.GetData(), name.GetLength()));
 
     if(it != m_MethodMap.end())
     {
-      return it->second.get();
+      return it->second;
     }
     // Search the parent for the method
     else if(GetParent() != nullptr)
     {
+      GetParent()->EnsureBuilt();
       return GetParent()->GetMethod(name);
     }
 
@@ -105,33 +227,39 @@ namespace Meta
   // Add a property to the meta data.
   Property &Data::AddProperty(Property *prop)
   {
+    FATAL_ERROR_IF(m_IsFrozen, "Adding a property to frozen meta data!\nClass Name: " + GetName() +
+                   "\nProperty Name: " + prop->GetName());
+
     // Check if the method already exists in the map.
     FATAL_ERROR_IF(m_PropertyMap.find(prop->GetName()) != m_PropertyMap.end(),
                    "Property already in map\nClass Name: " + GetName() +
                    "\nProperty Name: " + prop->GetName());
 
-    auto propertyShared = std::shared_ptr<Property>(prop);
-
     // Add it to the property map and add it to the ordered vector so that we can
     // serialize the data in the same order we registered it in.
-    m_PropertyMap.insert({prop->GetName(), propertyShared});
-    m_OrderedVector.push_back(propertyShared);
+    m_PropertyMap.insert({prop->GetName(), prop});
+    m_OrderedVector.push_back(prop);
 
     return *prop;
   }
 
-  // Get the with the given name.
-  Property *Data::GetProperty(const std::string &name)
+  // Get the property with the given name.
+  Property *Data::GetProperty(const HashedName &name) const
   {
-    auto it = m_PropertyMap.find(name);
+    // Once frozen, everything inherited is already in the flat table.
+    if(m_IsFrozen)
+      return m_FlatProperties.Find(name);
+
+    auto it = m_PropertyMap.find(std::string(name.GetData(), name.GetLength()));
 
     if(it != m_PropertyMap.end())
     {
-      return it->second.get();
+      return it->second;
     }
     // Search the parent for the method
     else if(GetParent() != nullptr)
     {
+      GetParent()->EnsureBuilt();
       return GetParent()->GetProperty(name);
     }
 
@@ -143,6 +271,7 @@ namespace Meta
   {
     FATAL_ERROR_IF(parent == this,
                    "Parenting Meta Data to itself!\nClass Name: " + GetName());
+    FATAL_ERROR_IF(m_IsFrozen, "Parenting frozen Meta Data!\nClass Name: " + GetName());
     m_Parent = parent;
   }
 
@@ -153,24 +282,25 @@ namespace Meta
   }
 
   // Check if this data has the given parent anywhere in the chain.
-  bool Data::HasParent(Data *parent) const
+  bool Data::HasParent(const Data *parent) const
   {
-    if(GetParent() == nullptr)
-    {
-      return false;
-    }
-    else if(GetParent() == parent)
-    {
-      return true;
-    }
-    else
-    {
-      return GetParent()->HasParent(parent);
-    }
+    return parent != this && IsA(parent);
+  }
+
+  // Get how many parents are above this type.  This is only known once frozen.
+  size_t Data::GetDepth() const
+  {
+    return m_Depth;
   }
 
   // Get the name of the meta data.
   const std::string &Data::GetName() const
+  {
+    return m_Name.GetString();
+  }
+
+  // Get the interned name of the meta data.
+  const Name &Data::GetInternedName() const
   {
     return m_Name;
   }
@@ -178,7 +308,7 @@ namespace Meta
   // Get the name as a const char *
   const char *Data::GetNameCStr() const
   {
-    return m_Name.c_str();
+    return m_Name.GetCStr();
   }
 
   // Get the size of the meta data.
@@ -187,9 +317,180 @@ namespace Meta
     return m_Size;
   }
 
+  // Get the dense id of this type.
+  TypeId Data::GetId() const
+  {
+    return m_Id;
+  }
+
   // Get the object info for this meta data.
   ObjectInfoBase *Data::GetObjectInfo() const
   {
-    return m_ObjectInfo.get();
-  }  
+    return m_ObjectInfo;
+  }
+
+  // Build the flat tables holding every property and method this type has, including
+  // the inherited ones.  After this the meta data can't be changed.
+  void Data::Freeze()
+  {
+    RegistryWriteLock lock;
+
+    // There is nothing to freeze until a lazily registered type is built (and building
+    // it freezes it if the registry is frozen).
+    Build();
+
+    if(m_IsFrozen)
+      return;
+
+    // Our display is our parent's display with us added on the end.
+    if(m_Parent != nullptr)
+    {
+      m_Parent->Freeze();
+      m_Display = m_Parent->m_Display;
+    }
+
+    m_Depth = m_Display.size();
+    m_Display.push_back(this);
+
+    // Walk from this type up through its parents.  The flat tables keep the first
+    // name added, so properties and methods hide ones with the same name further up
+    // the chain (the same as searching the parents did).
+    for(const Data *data = this; data != nullptr; data = data->GetParent())
+    {
+      for(const auto &prop : data->m_PropertyMap)
+      {
+        m_FlatProperties.Insert(Name(HashedName(prop.first)), prop.second);
+      }
+
+      for(const auto &method : data->m_MethodMap)
+      {
+        m_FlatMethods.Insert(Name(HashedName(method.first)), method.second);
+      }
+    }
+
+    BuildPropertySpans(this, m_Spans, false);
+    BuildPropertySpans(this, m_SerializedSpans, true);
+
+    m_IsFrozen = true;
+  }
+
+  // Whether or not the meta data has been frozen.
+  bool Data::IsFrozen() const
+  {
+    return m_IsFrozen;
+  }
+
+  // Hold onto the function that builds this type, to be run on first use.
+  void Data::SetBuilder(Builder builder)
+  {
+    RegistryWriteLock lock;
+
+    FATAL_ERROR_IF(m_IsFrozen, "Setting the builder of frozen Meta Data!\nClass Name: " + GetName());
+    m_Builder.store(builder, std::memory_order_release);
+  }
+
+  // Build a lazily registered type.  Other threads asking for the type while it's
+  // being built wait on the lock, and only see it once it's built (and frozen if the
+  // registry is), since the builder is cleared last.
+  void Data::Build()
+  {
+    RegistryWriteLock lock;
+
+    Builder builder = m_Builder.load(std::memory_order_relaxed);
+
+    // Freezing builds the type, so this gets called again while building.
+    if(builder == nullptr || m_IsBuilding)
+      return;
+
+    m_IsBuilding = true;
+
+    builder(this);
+
+    if(Meta::IsFrozen())
+      Freeze();
+
+    m_IsBuilding = false;
+    m_Builder.store(nullptr, std::memory_order_release);
+  }
+
+  // Whether or not the type's properties, methods, and parent have been registered.
+  bool Data::IsBuilt() const
+  {
+    return m_Builder.load(std::memory_order_acquire) == nullptr;
+  }
+
+  static std::atomic<bool> s_IsFrozen(false);
+
+  // Freeze all the registered meta data.  This should be called once static registration
+  // is done (at the start of main).  From then on the meta data is read only, so it can
+  // be shared between threads without locking, and every property and method lookup
+  // is a single probe no matter how deep the class hierarchy is.  Types registered
+  // after this (like from a plugin) are frozen as they are published, and lazily
+  // registered types are frozen when they're built.
+  void Freeze()
+  {
+    RegistryWriteLock lock;
+
+    for(TypeId id = 0; id < TypeTable::GetCount(); ++id)
+    {
+      Data *data = TypeTable::Get(id);
+
+      if(data->IsBuilt())
+        data->Freeze();
+    }
+
+    s_IsFrozen = true;
+  }
+
+  // Whether or not the meta data has been frozen.
+  bool IsFrozen()
+  {
+    return s_IsFrozen;
+  }
+
+  // Group the non-static properties of a type into spans, in the order they were
+  // registered, leaving out the ones that aren't serialized if asked to.  A member joins
+  // the span before it if both can be compared by their bytes and it starts right where
+  // the last one ended, so padding is never compared.
+  void BuildPropertySpans(const Data *data, PropertySpanVector &spans, bool serializedOnly)
+  {
+    const OrderedVector &orderedData = data->GetOrderedData();
+
+    spans.clear();
+
+    for(size_t i = 0; i < orderedData.size(); ++i)
+    {
+      const Property *prop = static_cast<const Property *>(orderedData[i]);
+
+      if(prop->IsStatic() || (serializedOnly && !prop->IsSerializable()))
+        continue;
+
+      bool isBytes = prop->HasOffset() && prop->IsBitwiseComparable();
+
+      if(isBytes && !spans.empty())
+      {
+        PropertySpan &last = spans.back();
+
+        if(last.m_Size != 0 && last.m_First + last.m_Count == i &&
+           last.m_Offset + last.m_Size == prop->GetOffset())
+        {
+          ++last.m_Count;
+          last.m_Size += prop->GetValueSize();
+          continue;
+        }
+      }
+
+      PropertySpan span;
+      span.m_First = i;
+      span.m_Count = 1;
+
+      if(isBytes)
+      {
+        span.m_Offset = prop->GetOffset();
+        span.m_Size = prop->GetValueSize();
+      }
+
+      spans.push_back(span);
+    }
+  }
 }
\ No newline at end of file
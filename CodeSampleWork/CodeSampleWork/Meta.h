@@ -7,23 +7,43 @@ Author: Alex Troyer
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <memory>
+#include <atomic>
 #include <type_traits>
 #include "Strip.h"
+#include "Name.h"
+#include "Arena.h"
 #include "ObjectInfo.h"
 #include "Macros.h"
 
+// Set this to 1 (in the project's preprocessor definitions, or build the project with
+// /p:MetaLazyRegistration=1) to register classes lazily.  Static registration then only
+// records each class's name, size, and how to build the rest, and the properties,
+// methods, and parent are built the first time the type is touched through GET_META or
+// GET_META_NAME.  This cuts startup time for programs that link in a lot of types but
+// only use a few.  When it's 0, GET_META doesn't check if the type is built (a type
+// given a builder at runtime with Data::SetBuilder is still built when it's looked up
+// by name).
+#ifndef META_LAZY_REGISTRATION
+#define META_LAZY_REGISTRATION 0
+#endif
+
 // Get meta information based off of type.
 #define GET_META(type) Meta::DataStorage<GET_TYPE(type)>::GetData()
+// Get the dense type id of a registered type.
+#define GET_META_ID(type) GET_META(type)->GetId()
 // Get meta information from the variable or expression you pass in
 // (This calls "GET_META" with decltype around the argument passed in)
 #define GET_META_VAR(var) GET_META(decltype(var))
-// Get meta data by string name.
-#define GET_META_NAME(name) Meta::NamedMetaStorage::GetMeta(name)
+// Get meta data by string name.  This takes a literal, a std::string, or a 
+// Meta::HashedName, and never builds a string.  Pass a literal through META_NAME, like
+// GET_META_NAME(META_NAME("int")), to make sure it is hashed at compile time.
+#define GET_META_NAME(name) Meta::NamedMetaStorage::GetMeta(Meta::HashedName(name))
 
 // Define a simple type, like an int, that doesn't need any methods or properties bound.
 #define DEFINE_SIMPLE_TYPE_NAME(name, type) \
-Meta::SimpleRegisterMetaData<type> Meta::SimpleRegister<type>::m_Register(name, sizeof(type), new Meta::ObjectInfo<type>())
+Meta::SimpleRegisterMetaData<type> Meta::SimpleRegister<type>::m_Register(name, sizeof(type), Meta::ArenaNew<Meta::ObjectInfo<type>>())
 
 // Define a simple type, like an int, that doesn't need any methods or properties bound.
 #define DEFINE_SIMPLE_TYPE(type) \
@@ -35,7 +55,14 @@ DEFINE_SIMPLE_TYPE_NAME(#type, type)
 template<typename> \
 friend struct RegisterMetaDataStruct
 
+// Set the parent of the class being registered.  The parent's record is reserved
+// if it hasn't registered yet, so this doesn't depend on static initialization order.
+#define PARENT(type) \
+data->AddParent(Meta::DataStorage<GET_TYPE(type)>::ReserveData())
+
 // Start the class registration with a different name than the type.
+// Everything between this and CLASS_END goes in the type's build function, which is
+// either run right away or on first use (see META_LAZY_REGISTRATION).
 #define CLASS_START_NAME(name, type) \
 struct \
 { \
@@ -54,9 +81,14 @@ struct Meta::RegisterMetaDataStruct<type>\
 { \
   static void Register() \
   { \
-    typedef type T; \
-    Meta::DataStorage<T>::SetData(name, sizeof(type), new Meta::ObjectInfo<T>()); \
-    Meta::Data *data = GET_META(T);
+    Meta::DataStorage<type>::SetData(name, sizeof(type), Meta::ArenaNew<Meta::ObjectInfo<type>>()); \
+    Meta::DataStorage<type>::SetBuilder(&Build); \
+    Meta::DataStorage<type>::Publish(); \
+  } \
+  \
+  static void Build(Meta::Data *data) \
+  { \
+    typedef type T;
 
 // Start the class registration
 #define CLASS_START(type) \
@@ -82,9 +114,41 @@ namespace Meta
 
   class Data;
 
-  typedef std::unordered_map<std::string, std::shared_ptr<MethodOverloads>> MethodMap;
-  typedef std::unordered_map<std::string, std::shared_ptr<Property>> PropertyMap;
-  typedef std::vector<std::shared_ptr<DataInfo>> OrderedVector;
+  // A list of types to walk through at compile time.
+  template<typename ...Types>
+  struct TypeList
+  {
+  };
+
+  // The basic types registered in RegisterBasicTypes.cpp (other than void).  Any::Visit
+  // checks for these, so keep the two in sync.
+  typedef TypeList<int, unsigned int, bool, short, unsigned short, char, signed char, 
+                   unsigned char, double, float, std::string> BasicTypes;
+
+  // Every registered type gets a small dense id that indexes into the TypeTable.
+  // Per-type side tables can use it to index flat arrays instead of keying maps
+  // with Data pointers.
+  typedef unsigned TypeId;
+  const TypeId InvalidTypeId = static_cast<TypeId>(-1);
+
+  // Everything these point to lives in the registry arena, so they don't own anything.
+  typedef std::unordered_map<std::string, MethodOverloads *> MethodMap;
+  typedef std::unordered_map<std::string, Property *> PropertyMap;
+  typedef std::vector<DataInfo *> OrderedVector;
+
+  // A run of a type's properties, by their index in the ordered data.  Plain members
+  // that sit right next to each other in the object and can be compared by their
+  // bytes are grouped into one span covering those bytes, so a whole run can be
+  // checked with one memcmp.  Any other property gets a span of its own with no bytes.
+  struct PropertySpan
+  {
+    size_t m_First = 0;
+    size_t m_Count = 0;
+    size_t m_Offset = 0;
+    size_t m_Size = 0;
+  };
+
+  typedef std::vector<PropertySpan> PropertySpanVector;
 
   // Registers meta data when constructed.
   template<typename T>
@@ -115,30 +179,78 @@ namespace Meta
   };
 
   // Holds the meta data information.  You get the different type information
-  // based off of the template parameter.
+  // based off of the template parameter.  The record pointer is atomic since it can
+  // be reserved at runtime (by handles and methods) while other threads read it.
   template<typename T>
   class DataStorage
   {
   public:
     static Data *GetData();
+    static Data *PeekData();
+    static Data *ReserveData();
     static void SetData(const std::string &name, size_t size, ObjectInfoBase *objectInfo);
+    static void SetBuilder(void (*builder)(Data *data));
+    static void Publish();
 
-    static Data *m_Data;
+    static std::atomic<Data *> m_Data;
     static RegisterMetaData<T> m_RegisterMetaData;
   };
 
+  // Held by anything that writes to the registry (registering a type, publishing it,
+  // freezing).  Readers never take it.  It is recursive since registering a type
+  // reserves records and publishes while already holding it.
+  class RegistryWriteLock
+  {
+  public:
+    RegistryWriteLock();
+    ~RegistryWriteLock();
+
+    RegistryWriteLock(const RegistryWriteLock &) = delete;
+    RegistryWriteLock &operator=(const RegistryWriteLock &) = delete;
+  };
+
+  // Stores every Data record, indexed by its type id.  Records are stored in fixed
+  // size blocks so they sit next to each other in memory, but are never moved once
+  // handed out (everything else holds onto Data pointers).
+  // The block table is a plain array so it is zero initialized before any static
+  // registration runs, just like the NamedMetaStorage map pointer.  Since blocks never
+  // move, readers only need the count (published once the record has its id) to
+  // safely read the table while another thread is reserving records.  A record can be
+  // reserved before its type registers, so one found by id may not have its name or
+  // object info yet.  Those are published along with the type's name.
+  class TypeTable
+  {
+  public:
+    static const TypeId BlockSize = 256;
+    static const TypeId MaxBlocks = 1024;
+
+    static Data *Reserve();
+    static Data *Get(TypeId id);
+    static TypeId GetCount();
+
+  private:
+    static Data *m_Blocks[MaxBlocks];
+    static std::atomic<TypeId> m_Count;
+  };
+
   // Is used to store all the meta data registered by string name.
+  // Lookups read an immutable snapshot of the map, so they never lock or wait.  Once
+  // the registry is frozen, adding a name copies the current snapshot, adds to the
+  // copy, and atomically swaps it in.  Readers still holding the old snapshot keep
+  // using it, so old snapshots are only retired, and deleted by ReclaimSnapshots.
   class NamedMetaStorage
   {
   public:
     template<typename>
     friend class DataStorage;
 
-    static Data *GetMeta(const std::string &name);
+    static Data *GetMeta(const HashedName &name);
+    static void ReclaimSnapshots();
 
   private:
-    static void AddMetaData(const std::string &name, Data *meta);
-    static std::unordered_map<std::string, Data *> *m_MetaMap;
+    static void AddMetaData(Data *meta);
+    static std::atomic<NameMap<Data> *> m_MetaMap;
+    static std::vector<NameMap<Data> *> *m_Retired;
   };
 
   // This holds all the meta information for a type.
@@ -147,6 +259,10 @@ namespace Meta
   public:
     template<typename>
     friend class DataStorage;
+    friend class TypeTable;
+
+    // Fills in the properties, methods, and parent of a type.
+    typedef void (*Builder)(Data *data);
 
     Data() = default;
     ~Data() = default;
@@ -154,35 +270,89 @@ namespace Meta
     const OrderedVector &GetOrderedData() const;
     const MethodMap &GetMethodMap() const;
     const PropertyMap &GetPropertyMap() const;
+    const PropertySpanVector &GetPropertySpans() const;
+    const PropertySpanVector &GetSerializedPropertySpans() const;
 
     Method &AddMethod(Method *method);
-    MethodOverloads *GetMethod(const std::string &name);
+    MethodOverloads *GetMethod(const HashedName &name) const;
 
     Property &AddProperty(Property *prop);
-    Property *GetProperty(const std::string &name);
+    Property *GetProperty(const HashedName &name) const;
 
     void AddParent(Data *parent);
     Data *GetParent() const;
-    bool HasParent(Data *parent) const;
+    bool HasParent(const Data *parent) const;
+    bool IsA(const Data *type) const;
+    size_t GetDepth() const;
 
     const std::string &GetName() const;
+    const Name &GetInternedName() const;
     const char *GetNameCStr() const;
     size_t GetSize() const;
+    TypeId GetId() const;
 
     ObjectInfoBase *GetObjectInfo() const;
+    const LifetimeTable &GetLifetime() const;
+
+    void Freeze();
+    bool IsFrozen() const;
+
+    void SetBuilder(Builder builder);
+    void Build();
+    void EnsureBuilt();
+    bool IsBuilt() const;
 
   private:
+    // A copy of the object info's table so building and destroying objects of the
+    // type doesn't have to go through the object info.  It is aligned so it never
+    // straddles two cache lines.  Data is only made in the registry arena, which 
+    // respects the alignment.
+    alignas(CacheLineSize) LifetimeTable m_Lifetime;
     // This holds properties in order registered for serialization.
     OrderedVector m_OrderedVector;
     // Holds all the methods and their overloads.
     MethodMap m_MethodMap;
     // Holds all the properties.
     PropertyMap m_PropertyMap;
-    std::string m_Name;
-    size_t m_Size;
-    std::shared_ptr<ObjectInfoBase> m_ObjectInfo;
+    Name m_Name;
+    size_t m_Size = 0;
+    TypeId m_Id = InvalidTypeId;
+    ObjectInfoBase *m_ObjectInfo = nullptr;
     Data *m_Parent = nullptr;
+
+    // Filled in by Freeze with everything inherited, so a lookup is one probe no
+    // matter how deep the class is.
+    NameMap<Property> m_FlatProperties;
+    NameMap<MethodOverloads> m_FlatMethods;
+    bool m_IsFrozen = false;
+
+    // Also filled in by Freeze.  The display holds every ancestor indexed by its depth
+    // (with this type at the end), so checking if this derives from a type is a single
+    // compare at that type's depth.
+    std::vector<const Data *> m_Display;
+    size_t m_Depth = 0;
+
+    // Also filled in by Freeze.  The non-static properties in the ordered data grouped
+    // into spans, so comparing and hashing whole objects doesn't have to work them out
+    // every time.  Hashing only looks at the serialized ones.
+    PropertySpanVector m_Spans;
+    PropertySpanVector m_SerializedSpans;
+
+    // Set while the type is registered but not built yet.  This is atomic since
+    // readers check it on every GET_META while another thread may be building.
+    std::atomic<Builder> m_Builder{nullptr};
+    bool m_IsBuilding = false;
   };
+
+  void Freeze();
+  bool IsFrozen();
+
+  void BuildPropertySpans(const Data *data, PropertySpanVector &spans, bool serializedOnly);
+
+  template<typename T>
+  T *Cast(const Data *type, void *object);
+  template<typename T>
+  const T *Cast(const Data *type, const void *object);
 }
 
 #include "Meta.hpp"
\ No newline at end of file
@@ -21,12 +21,13 @@ namespace Meta
   template<typename T>
   RegisterMetaData<T>::RegisterMetaData()
   {
+    RegistryWriteLock lock;
     RegisterMetaDataStruct<T>::Register();
   }
 
   // Initialize the meta data to nullptr because this happens before constructors.
   template<typename T>
-  Data *DataStorage<T>::m_Data = nullptr;
+  std::atomic<Data *> DataStorage<T>::m_Data(nullptr);
 
   // Register simple meta data information.
   template<typename T>
@@ -34,8 +35,10 @@ namespace Meta
                                                     size_t size, 
                                                     ObjectInfoBase *objectInfo)
   {
+    RegistryWriteLock lock;
     BindData();
     Meta::DataStorage<T>::SetData(name, size, objectInfo);
+    Meta::DataStorage<T>::Publish();
   }
 
   // This method helps with keeping data referenced (I think?  I can't remember)
@@ -48,25 +51,158 @@ namespace Meta
   template<typename T>
   RegisterMetaData<T> DataStorage<T>::m_RegisterMetaData;
 
-  // Get meta data.
+  // Get meta data.  A lazily registered type is built the first time it's asked for.
+  // Without lazy registration every type is built when it registers, so this doesn't
+  // check.
   template<typename T>
   Data *DataStorage<T>::GetData()
   {
-    return m_Data;
+    Data *data = m_Data.load(std::memory_order_acquire);
+
+  #if META_LAZY_REGISTRATION
+    if(data != nullptr)
+      data->EnsureBuilt();
+  #endif
+
+    return data;
+  }
+
+  // Get the record for this type if it has one, without building or reserving it.
+  // This is enough to compare types.
+  template<typename T>
+  Data *DataStorage<T>::PeekData()
+  {
+    return m_Data.load(std::memory_order_acquire);
   }
   
-  // Set some of the data information, and also store it by name.
+  // Get the record for this type, reserving it in the TypeTable if the type hasn't
+  // registered yet.  Registration fills in the same record later.  Reserving takes the
+  // registry lock and checks again, so two threads can't reserve two records.
+  template<typename T>
+  Data *DataStorage<T>::ReserveData()
+  {
+    Data *data = m_Data.load(std::memory_order_acquire);
+
+    if(data != nullptr)
+      return data;
+
+    RegistryWriteLock lock;
+    data = m_Data.load(std::memory_order_relaxed);
+
+    if(data == nullptr)
+    {
+      data = TypeTable::Reserve();
+      m_Data.store(data, std::memory_order_release);
+    }
+
+    return data;
+  }
+  
+  // Set some of the data information.  The record itself lives in the TypeTable, 
+  // which also gives the type its id.  It can't be found by name until it's published.
+  // The object info is never deleted, so it should be built in the registry arena.
   template<typename T>
   void DataStorage<T>::SetData(const std::string &name, 
                                size_t size, 
                                ObjectInfoBase *objectInfo)
   {
-    m_Data = new Data;
+    RegistryWriteLock lock;
+    Data *data = ReserveData();
+
+    data->m_Name = Name(name);
+    data->m_Size = size;
+    data->m_ObjectInfo = objectInfo;
+    data->m_Lifetime = objectInfo->GetLifetime();
+  }
+
+  // Give the function that builds the rest of the type's meta data.  Normally it runs
+  // right away, but with lazy registration it waits until the type is first used.
+  template<typename T>
+  void DataStorage<T>::SetBuilder(void (*builder)(Data *data))
+  {
+    RegistryWriteLock lock;
+    Data *data = ReserveData();
+
+  #if META_LAZY_REGISTRATION
+    data->SetBuilder(builder);
+  #else
+    builder(data);
+  #endif
+  }
+
+  // Store the meta data by name once it's done being registered.  If the registry is
+  // already frozen (other threads may be reading it), the type is frozen first so it
+  // is read only by the time anyone else can find it.  A type waiting to be built is
+  // frozen when it's built instead.
+  template<typename T>
+  void DataStorage<T>::Publish()
+  {
+    RegistryWriteLock lock;
+    Data *data = ReserveData();
+
+    if(Meta::IsFrozen() && data->IsBuilt())
+      data->Freeze();
+
+    NamedMetaStorage::AddMetaData(data);
+  }
+
+  // Get the record for the given type id.  This is inlined since type checks and
+  // per-type side tables go through it.  It doesn't build lazily registered types,
+  // so call EnsureBuilt before looking at properties or methods.
+  inline Data *TypeTable::Get(TypeId id)
+  {
+    return id < m_Count.load(std::memory_order_acquire) ? &m_Blocks[id / BlockSize][id % BlockSize] : nullptr;
+  }
+
+  // Build the type if it was lazily registered and hasn't been built yet.  Once built
+  // this is a single load, so it's inlined into GET_META.
+  inline void Data::EnsureBuilt()
+  {
+    if(m_Builder.load(std::memory_order_acquire) != nullptr)
+      Build();
+  }
 
-    m_Data->m_Name = name;
-    m_Data->m_Size = size;
-    m_Data->m_ObjectInfo = std::shared_ptr<ObjectInfoBase>(objectInfo);
+  // Get the function pointers for building and destroying objects of the type.  This
+  // is inlined since Any goes through it on every copy, move and destroy.
+  inline const LifetimeTable &Data::GetLifetime() const
+  {
+    return m_Lifetime;
+  }
 
-    NamedMetaStorage::AddMetaData(name, m_Data);
+  // Check if this type is the given type or derives from it.  Once frozen this is a
+  // bounds check and one compare into the display, no matter how deep the hierarchy is.
+  inline bool Data::IsA(const Data *type) const
+  {
+    if(m_IsFrozen && type->m_IsFrozen)
+    {
+      return type->m_Depth <= m_Depth && m_Display[type->m_Depth] == type;
+    }
+
+    // Haven't built the displays yet, so walk up the parents.
+    for(const Data *data = this; data != nullptr; data = data->m_Parent)
+    {
+      if(data == type)
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Reflective checked downcast.  Gives back the object as a T if its type (given by
+  // the meta data) is T or derives from T, otherwise nullptr.  Like the rest of the
+  // meta system, this expects parents to live at the start of the object.
+  template<typename T>
+  T *Cast(const Data *type, void *object)
+  {
+    return (object != nullptr && type->IsA(GET_META(T))) ? reinterpret_cast<T *>(object) : nullptr;
+  }
+
+  // Reflective checked downcast of a const object.
+  template<typename T>
+  const T *Cast(const Data *type, const void *object)
+  {
+    return Cast<T>(type, const_cast<void *>(object));
   }
 }
\ No newline at end of file
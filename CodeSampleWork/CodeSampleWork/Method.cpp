@@ -5,6 +5,7 @@ Author: Alex Troyer
 *****************************************************************************/
 #include "Method.h"
 #include "Meta.h"
+#include <cstdint>
 
 namespace Meta
 {
@@ -35,19 +36,19 @@ namespace Meta
   }
 
   // Default call for a non-const object, which does nothing.
-  Any Method::Call(void *, const std::vector<Any> &) const
+  Any Method::Call(void *, ArgumentSpan) const
   {
     return Any();
   }
 
   // Default call for a const object, which does nothing.
-  Any Method::Call(const void *, const std::vector<Any> &) const
+  Any Method::Call(const void *, ArgumentSpan) const
   {
     return Any();
   }
 
   // Default call for a static method, which does nothing.
-  Any Method::CallStatic(const std::vector<Any> &) const
+  Any Method::CallStatic(ArgumentSpan) const
   {
     return Any();
   }
@@ -58,13 +59,52 @@ namespace Meta
     return m_IsStatic;
   }
 
-  // Get whether or not the types of the Any types and the argument meta data are
+  // Get the class the methods were added to.
+  Data *MethodOverloads::GetOwner() const
+  {
+    return m_Owner;
+  }
+
+  // Get the list of overloads.
+  const std::vector<Method *> &MethodOverloads::GetMethods() const
+  {
+    return m_Methods;
+  }
+
+  // Get the meta data of an argument, whether it's passed as an Any or as meta data.
+  static Data *GetArgumentMeta(const Any &arg)
+  {
+    return arg.GetMeta();
+  }
+
+  static Data *GetArgumentMeta(Data *arg)
+  {
+    return arg;
+  }
+
+  // Hash the type ids of a list of arguments.
+  template<typename Argument>
+  static size_t HashSignature(const Argument *args, size_t count)
+  {
+    std::uint64_t hash = HashSeed ^ count;
+
+    for(size_t i = 0; i < count; ++i)
+    {
+      Data *meta = GetArgumentMeta(args[i]);
+      hash = (hash ^ (meta != nullptr ? meta->GetId() : InvalidTypeId)) * HashMultiplier;
+    }
+
+    return static_cast<size_t>(FinalizeHash(hash));
+  }
+
+  // Get whether or not the types of the arguments and the argument meta data are
   // the same.
-  static bool IsSameTypes(const std::vector<Any> &args, const std::vector<Meta::Data *> &argMeta)
+  template<typename Argument>
+  static bool IsSameTypes(const Argument *args, size_t count, const std::vector<Meta::Data *> &argMeta)
   {
-    for(unsigned i = 0; i < args.size(); i++)
+    for(size_t i = 0; i < count; i++)
     {
-      if(args[i].GetMeta() != argMeta[i])
+      if(GetArgumentMeta(args[i]) != argMeta[i])
       {
         return false;
       }
@@ -73,62 +113,64 @@ namespace Meta
     return true;
   }
 
-  // Finds a method that share the same properties as the arguments passed in.
-  static std::shared_ptr<Method> FindMethod(const std::vector<std::shared_ptr<Method>> &methods,
-                                            const std::vector<Any> &args, 
-                                            bool isConst)
+  // Finds the method that takes the given arguments.  A const object can only call a
+  // const method, and a non-const object calls a const method if there isn't a
+  // non-const one with the same arguments.
+  template<typename Argument>
+  Method *MethodOverloads::Resolve(const Argument *args, size_t count, bool isConst) const
   {
     // If we only have one method, we simplify the search a bit.
-    if(methods.size() == 1)
+    if(m_Methods.size() == 1)
     {
       // As long as the argument count is the same, if it is a const object calling 
       // a const method or a non-const object calling either a const or non-const method,
       //and if the arguments are correct, we can use this given method.
-      if(methods.front()->GetArgNum() == args.size() &&
-         (methods.front()->IsConst() == isConst || 
-         (isConst == false && methods.front()->IsConst())) &&
-         IsSameTypes(args, methods.front()->GetArguments()))
+      if(m_Methods.front()->GetArgNum() == count &&
+         (m_Methods.front()->IsConst() == isConst || 
+         (isConst == false && m_Methods.front()->IsConst())) &&
+         IsSameTypes(args, count, m_Methods.front()->GetArguments()))
       {
-        return methods.front();
+        return m_Methods.front();
       }
 
       return nullptr;
     }
 
-    // We can call a const method with a non const object so hold onto the
-    // const method if we find it and don't find a non const one down the road.
-    std::shared_ptr<Method> constMethod = nullptr;
+    // Only the overloads taking this many arguments can match.
+    if(count >= m_Arities.size() || m_Arities[count].m_Count == 0)
+      return nullptr;
+
+    const std::vector<Signature> &table = m_Arities[count].m_Table;
+    size_t hash = HashSignature(args, count);
+    size_t mask = table.size() - 1;
 
-    // Go through all the methods to find a match.
-    for(const std::shared_ptr<Method> &method : methods)
+    // The table is never more than half full, so this always hits an empty slot.
+    for(size_t slot = hash & mask; ; slot = (slot + 1) & mask)
     {
-      // If the methods have the same argument count and the argument types match
-      // up, we have a match.
-      if(method->GetArgNum() == args.size() &&
-         IsSameTypes(args, method->GetArguments()))
+      const Signature &signature = table[slot];
+      const Method *method = signature.m_Method != nullptr ? signature.m_Method : signature.m_ConstMethod;
+
+      if(method == nullptr)
+        return nullptr;
+
+      if(signature.m_Hash == hash && IsSameTypes(args, count, method->GetArguments()))
       {
-        // If the const is correct, return this method.
-        if(method->IsConst() == isConst)
-        {
-          return method;
-        }
-        // Since we have a non-const object with a const method,
-        // we can't assume even though this is correct that this is the best match.
-        // Hold onto this method to return later if we don't find a non-const method.
-        else if(isConst == false)
-        {
-          constMethod = method;
-        }
+        if(isConst || signature.m_Method == nullptr)
+          return signature.m_ConstMethod;
+
+        return signature.m_Method;
       }
     }
+  }
 
-    // If we found the const method for a non-const object, return that now.
-    // Otherwise we are returning a nullptr.
-    return constMethod;
+  // Find the overload that takes arguments of the given types.
+  Method *MethodOverloads::FindMethod(const std::vector<Data *> &argMeta, bool isConst) const
+  {
+    return Resolve(argMeta.data(), argMeta.size(), isConst);
   }
 
   // Call for a non-const object.
-  Any MethodOverloads::Call(void *object, const std::vector<Any> &args) const
+  Any MethodOverloads::Call(void *object, ArgumentSpan args) const
   {
     // If these methods are static, we can't call this method with an object.
     if(IsStatic() == true)
@@ -137,7 +179,7 @@ namespace Meta
     }
 
     // Find the method for the given arguments.
-    std::shared_ptr<Method> method = FindMethod(m_Methods, args, false); 
+    Method *method = Resolve(args.GetData(), args.GetSize(), false);
 
     // If we found the method, call it.
     if(method)
@@ -150,7 +192,7 @@ namespace Meta
     }
   }
 
-  Any MethodOverloads::Call(const void *object, const std::vector<Any> &args) const
+  Any MethodOverloads::Call(const void *object, ArgumentSpan args) const
   {
     // If these methods are static, we can't call this method with an object.
     if(IsStatic() == true)
@@ -159,7 +201,7 @@ namespace Meta
     }
 
     // Find the method for the given arguments.
-    std::shared_ptr<Method> method = FindMethod(m_Methods, args, true);
+    Method *method = Resolve(args.GetData(), args.GetSize(), true);
 
     // If we found the method, call it.
     if(method)
@@ -172,7 +214,7 @@ namespace Meta
     }
   }
 
-  Any MethodOverloads::CallStatic(const std::vector<Any> &args) const
+  Any MethodOverloads::CallStatic(ArgumentSpan args) const
   {
     // If these methods aren't static, we can't call this method.
     if(IsStatic() == false)
@@ -181,7 +223,7 @@ namespace Meta
     }
 
     // Find the method for the given arguments.
-    std::shared_ptr<Method> method = FindMethod(m_Methods, args, false);
+    Method *method = Resolve(args.GetData(), args.GetSize(), false);
 
     // If we found the method, call it.
     if(method)
@@ -203,7 +245,7 @@ namespace Meta
     if(m_Methods.empty())
     {
       m_IsStatic = method->IsStatic();
-      m_Methods.push_back(std::shared_ptr<Method>(method));
+      m_Methods.push_back(method);
     }
     else
     {
@@ -217,7 +259,7 @@ namespace Meta
       // In debug, iterate through all the methods and make sure there are no conflicts with
       // argument count, argument types, and if the methods are the same const.
       #ifdef _DEBUG
-      for(std::shared_ptr<Method> &storedMethod : m_Methods)
+      for(const Method *storedMethod : m_Methods)
       {
         if(method->GetArgNum() == storedMethod->GetArgNum() &&
            method->GetArguments() == storedMethod->GetArguments() &&
@@ -230,7 +272,74 @@ namespace Meta
       #endif
 
       // We passed all the tests at this point so add the method as an overload.
-      m_Methods.push_back(std::shared_ptr<Method>(method));
+      m_Methods.push_back(method);
     }
+
+    AddSignature(method);
+  }
+
+  // Put a method in the table for its number of arguments.  The table is doubled
+  // whenever it would be more than half full.
+  void MethodOverloads::AddSignature(Method *method)
+  {
+    size_t count = method->GetArgNum();
+
+    if(m_Arities.size() <= count)
+      m_Arities.resize(count + 1);
+
+    Arity &arity = m_Arities[count];
+
+    if((arity.m_Count + 1) * 2 > arity.m_Table.size())
+    {
+      std::vector<Signature> oldTable;
+      oldTable.swap(arity.m_Table);
+      arity.m_Table.resize(oldTable.empty() ? 4 : oldTable.size() * 2);
+
+      size_t mask = arity.m_Table.size() - 1;
+
+      for(const Signature &signature : oldTable)
+      {
+        if(signature.m_Method == nullptr && signature.m_ConstMethod == nullptr)
+          continue;
+
+        size_t slot = signature.m_Hash & mask;
+
+        while(arity.m_Table[slot].m_Method != nullptr || arity.m_Table[slot].m_ConstMethod != nullptr)
+        {
+          slot = (slot + 1) & mask;
+        }
+
+        arity.m_Table[slot] = signature;
+      }
+    }
+
+    const std::vector<Data *> &argMeta = method->GetArguments();
+    size_t hash = HashSignature(argMeta.data(), count);
+    size_t mask = arity.m_Table.size() - 1;
+    size_t slot = hash & mask;
+
+    // Find the signature if an overload with the other const-ness already added it,
+    // otherwise take the first empty slot.
+    for(;; slot = (slot + 1) & mask)
+    {
+      Signature &signature = arity.m_Table[slot];
+      const Method *stored = signature.m_Method != nullptr ? signature.m_Method : signature.m_ConstMethod;
+
+      if(stored == nullptr)
+      {
+        signature.m_Hash = hash;
+        ++arity.m_Count;
+        break;
+      }
+
+      if(signature.m_Hash == hash && stored->GetArguments() == argMeta)
+        break;
+    }
+
+    // Like searching the overloads in order, the first one added with a signature wins.
+    Method *&entry = method->IsConst() ? arity.m_Table[slot].m_ConstMethod : arity.m_Table[slot].m_Method;
+
+    if(entry == nullptr)
+      entry = method;
   }
 }
\ No newline at end of file
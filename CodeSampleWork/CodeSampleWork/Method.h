@@ -8,8 +8,9 @@ Author: Alex Troyer
 #include "DataInfo.h"
 #include "Any.h"
 #include <vector>
-#include <functional>
+#include <initializer_list>
 #include <type_traits>
+#include <utility>
 #include "Macros.h"
 
 // If a method you are registering is overloaded, you must use
@@ -47,8 +48,39 @@ PASTE_PARAMS(FOR_ALL_OVERLOADS, method, __VA_ARGS__) struct forcesemicolon
 
 namespace Meta
 {
+  // The arguments for a call.  It only points at them, so the caller can keep them in
+  // an array on the stack instead of a vector, and a call doesn't allocate.
+  class ArgumentSpan
+  {
+  public:
+    ArgumentSpan() = default;
+    ArgumentSpan(const Any *args, size_t count);
+    ArgumentSpan(const std::vector<Any> &args);
+    ArgumentSpan(std::initializer_list<Any> args);
+
+    const Any &operator[](size_t index) const;
+
+    const Any *begin() const;
+    const Any *end() const;
+
+    const Any *GetData() const;
+    size_t GetSize() const;
+    bool IsEmpty() const;
+
+  private:
+    const Any *m_Args = nullptr;
+    size_t m_Count = 0;
+  };
+
+  // Gives a different address for each type, to check a type that was erased.
+  template<typename T>
+  const void *GetTypeTag();
+
   // Base class for a method.
   // The method "GetMetaData" is the return value.
+  // Methods also have an invoker, a function that calls them with their real argument
+  // and return types.  Its type only depends on those, not on the class, so a typed
+  // handle can ask for the invoker it expects and call it without any Anys.
   class Method : public DataInfo
   {
   public:
@@ -58,9 +90,12 @@ namespace Meta
     size_t GetArgNum() const;
     const std::vector<Meta::Data *> &GetArguments() const;
 
-    virtual Any Call(void *object, const std::vector<Any> &args = {}) const;
-    virtual Any Call(const void *object, const std::vector<Any> &args = {}) const;
-    virtual Any CallStatic(const std::vector<Any> &args = {}) const;
+    template<typename Invoker>
+    Invoker GetInvoker() const;
+
+    virtual Any Call(void *object, ArgumentSpan args = {}) const;
+    virtual Any Call(const void *object, ArgumentSpan args = {}) const;
+    virtual Any CallStatic(ArgumentSpan args = {}) const;
 
     template<typename T, typename ...Args>
     Any Call(T &object, Args... args) const;
@@ -70,24 +105,42 @@ namespace Meta
     Any CallStatic(Args... args) const;
 
   protected:
+    template<typename Invoker>
+    void SetInvoker(Invoker invoker);
+
     std::vector<Meta::Data *> m_ArgumentMeta;
 
   private:
+    // The invoker is stored as one function pointer type, and the tag is which type it
+    // really is.
+    typedef void (*ErasedInvoker)();
+
     size_t m_ArgNum;
     bool m_IsConst;
+    ErasedInvoker m_Invoker = nullptr;
+    const void *m_InvokerTag = nullptr;
   };
 
-  // Holds methods and their overloads.
+  // Holds methods and their overloads.  Overloads are matched by the exact types of
+  // the arguments, so every signature that can find a method is known when the method
+  // is added.  Each one is put in a table for its number of arguments, keyed by the
+  // hash of its argument type ids, so finding the overload for a call is one probe
+  // instead of checking every overload.  The tables are only written while registering,
+  // so calls read them without locking.
   class MethodOverloads
   {
   public:
     friend class Data;
 
     bool IsStatic() const;
+    Data *GetOwner() const;
+    const std::vector<Method *> &GetMethods() const;
 
-    Any Call(void *object, const std::vector<Any> &args = {}) const;
-    Any Call(const void *object, const std::vector<Any> &args = {}) const;
-    Any CallStatic(const std::vector<Any> &args = {}) const;
+    Method *FindMethod(const std::vector<Data *> &argMeta, bool isConst) const;
+
+    Any Call(void *object, ArgumentSpan args = {}) const;
+    Any Call(const void *object, ArgumentSpan args = {}) const;
+    Any CallStatic(ArgumentSpan args = {}) const;
 
     template<typename T, typename ...Args>
     Any Call(T &object, Args... args) const;
@@ -97,55 +150,89 @@ namespace Meta
     Any CallStatic(Args... args) const;
 
   private:
+    // The methods with one list of argument types.  A const and a non-const overload
+    // can share the same arguments, and which one is called depends on the object.
+    struct Signature
+    {
+      size_t m_Hash = 0;
+      Method *m_Method = nullptr;
+      Method *m_ConstMethod = nullptr;
+    };
+
+    // The signatures that take the same number of arguments, in an open addressed
+    // table whose size is a power of two.
+    struct Arity
+    {
+      std::vector<Signature> m_Table;
+      size_t m_Count = 0;
+    };
+
     void AddMethod(Method *method);
+    void AddSignature(Method *method);
+
+    template<typename Argument>
+    Method *Resolve(const Argument *args, size_t count, bool isConst) const;
+
     Data *m_Owner = nullptr;
 
     bool m_IsStatic = false;
 
-    std::vector<std::shared_ptr<Method>> m_Methods;
+    std::vector<Method *> m_Methods;
+    // Indexed by the number of arguments.
+    std::vector<Arity> m_Arities;
   };
 
-  // Non const non static method.
+  // Non const non static method.  The method pointer is called directly.
   template<typename Class, typename Return, typename ...Args>
   class Method_T : public Method
   {
   public:
-    Method_T(const std::string &name, std::function<Return (Class &, Args...)> func);
+    typedef Return (Class::*Function)(Args...);
+    typedef Return (*Invoker)(const Method *, void *, Args...);
+
+    Method_T(const std::string &name, Function func);
 
-    virtual Any Call(void *object, const std::vector<Any> &args = {}) const;
+    virtual Any Call(void *object, ArgumentSpan args = {}) const;
 
   private:
+    static Return Invoke(const Method *method, void *object, Args... args);
 
-    std::function<Return (Class &, Args...)> m_Function;
+    Function m_Function;
   };
 
-  // Const method.
+  // Const method.  The method pointer is called directly.
   template<typename Class, typename Return, typename ...Args>
   class Method_const_T : public Method
   {
   public:
-    Method_const_T(const std::string &name, std::function<Return(const Class &, Args...)> func);
+    typedef Return (Class::*Function)(Args...) const;
+    typedef Return (*Invoker)(const Method *, void *, Args...);
 
-    virtual Any Call(void *object, const std::vector<Any> &args = {}) const;
-    virtual Any Call(const void *object, const std::vector<Any> &args = {}) const;
+    Method_const_T(const std::string &name, Function func);
+
+    virtual Any Call(void *object, ArgumentSpan args = {}) const;
+    virtual Any Call(const void *object, ArgumentSpan args = {}) const;
 
   private:
+    static Return Invoke(const Method *method, void *object, Args... args);
 
-    std::function<Return(const Class &, Args...)> m_Function;
+    Function m_Function;
   };
 
-  // Static method.
+  // Static method.  The function pointer is called directly, and is its own invoker.
   template<typename Return, typename ...Args>
   class Method_static_T : public Method
   {
   public:
-    Method_static_T(const std::string &name, std::function<Return(Args...)> func);
+    typedef Return (*Function)(Args...);
+
+    Method_static_T(const std::string &name, Function func);
 
-    virtual Any CallStatic(const std::vector<Any> &args = {}) const;
+    virtual Any CallStatic(ArgumentSpan args = {}) const;
 
   private:
 
-    std::function<Return (Args...)> m_Function;
+    Function m_Function;
   };
 }
 
@@ -7,32 +7,125 @@ Author: Alex Troyer
 
 namespace Meta
 {
+  ///////////////////////////////////////////////////////////////
+  // ArgumentSpan
+  ///////////////////////////////////////////////////////////////
+
+  // Point at a number of arguments in a row.
+  inline ArgumentSpan::ArgumentSpan(const Any *args, size_t count)
+    : m_Args(args)
+    , m_Count(count)
+  {
+  }
+
+  // Point at the arguments in a vector.
+  inline ArgumentSpan::ArgumentSpan(const std::vector<Any> &args)
+    : m_Args(args.data())
+    , m_Count(args.size())
+  {
+  }
+
+  // Point at arguments written in braces.  They only live until the end of the
+  // statement, so this should only be used to pass them to a call.
+  inline ArgumentSpan::ArgumentSpan(std::initializer_list<Any> args)
+    : m_Args(args.begin())
+    , m_Count(args.size())
+  {
+  }
+
+  // Get an argument.
+  inline const Any &ArgumentSpan::operator[](size_t index) const
+  {
+    return m_Args[index];
+  }
+
+  // Get the first argument, to loop over them.
+  inline const Any *ArgumentSpan::begin() const
+  {
+    return m_Args;
+  }
+
+  // Get one past the last argument.
+  inline const Any *ArgumentSpan::end() const
+  {
+    return m_Args + m_Count;
+  }
+
+  // Get the arguments.
+  inline const Any *ArgumentSpan::GetData() const
+  {
+    return m_Args;
+  }
+
+  // Get the number of arguments.
+  inline size_t ArgumentSpan::GetSize() const
+  {
+    return m_Count;
+  }
+
+  // Whether or not there are no arguments.
+  inline bool ArgumentSpan::IsEmpty() const
+  {
+    return m_Count == 0;
+  }
+
+  // Each type gets its own tag, since each one has its own static.  The static isn't
+  // const so the linker can't fold identical ones together into a single address.
+  template<typename T>
+  const void *GetTypeTag()
+  {
+    static char tag;
+    return &tag;
+  }
+
   ///////////////////////////////////////////////////////////////
   // Method
   ///////////////////////////////////////////////////////////////
 
+  // Get the invoker if it is the given type, otherwise nullptr.
+  template<typename Invoker>
+  Invoker Method::GetInvoker() const
+  {
+    if(m_InvokerTag != GetTypeTag<Invoker>())
+      return nullptr;
+
+    return reinterpret_cast<Invoker>(m_Invoker);
+  }
+
+  // Store the invoker, remembering its type.
+  template<typename Invoker>
+  void Method::SetInvoker(Invoker invoker)
+  {
+    m_Invoker = reinterpret_cast<ErasedInvoker>(invoker);
+    m_InvokerTag = GetTypeTag<Invoker>();
+  }
+
   // Helper to call a non-const method without having to do casting and manual creation of
-  // the Any types.
+  // the Any types.  The arguments are kept on the stack, so this doesn't allocate.  The
+  // array has an extra Any at the end so it isn't empty when there are no arguments.
   template<typename T, typename... Args>
   Any Method::Call(T &object, Args... args) const
   {
-    return Call(reinterpret_cast<void *>(&object), {Any::AnyRef(args)...});
+    const Any argArray[] = {Any::AnyRef(args)..., Any()};
+    return Call(reinterpret_cast<void *>(&object), ArgumentSpan(argArray, sizeof...(Args)));
   }
 
   // Helper to call a const method without having to do casting and manual creation of
-  // the Any types.
+  // the Any types.  The arguments are kept on the stack, so this doesn't allocate.
   template<typename T, typename... Args>
   Any Method::Call(const T &object, Args... args) const
   {
-    return Call(reinterpret_cast<const void *>(&object), {Any::AnyRef(args)...});
+    const Any argArray[] = {Any::AnyRef(args)..., Any()};
+    return Call(reinterpret_cast<const void *>(&object), ArgumentSpan(argArray, sizeof...(Args)));
   }
 
   // Helper to call a static method without having to do casting and manual creation of
-  // the Any types.
+  // the Any types.  The arguments are kept on the stack, so this doesn't allocate.
   template<typename ...Args>
   Any Method::CallStatic(Args ...args) const
   {
-    return CallStatic({Any::AnyRef(args)...});
+    const Any argArray[] = {Any::AnyRef(args)..., Any()};
+    return CallStatic(ArgumentSpan(argArray, sizeof...(Args)));
   }
   
   // Helper structs in order to expand a list of numbers that expands from 0 to N.
@@ -57,11 +150,13 @@ namespace Meta
     };
   }
 
-  // Get the meta data information of all the types in the variadic template.
+  // Get the meta data information of all the types in the variadic template.  The
+  // records are reserved if the types haven't registered yet, so this doesn't depend on
+  // static initialization order.
   template<typename ...Args>
   void CaptureArgumentMeta(std::vector<Meta::Data *> &argumentMeta)
   {
-    argumentMeta.assign({GET_META(Args)...});
+    argumentMeta.assign({DataStorage<GET_TYPE(Args)>::ReserveData()...});
   }
 
   ///////////////////////////////////////////////////////////////
@@ -69,27 +164,30 @@ namespace Meta
   ///////////////////////////////////////////////////////////////
 
   // Helper to call a non-const method without having to do casting and manual creation of
-  // the Any types.
+  // the Any types.  The arguments are kept on the stack, so this doesn't allocate.
   template<typename T, typename ...Args>
   Any MethodOverloads::Call(T &object, Args... args) const
   {
-    return Call(reinterpret_cast<void *>(&object), {Any::AnyRef(args)...});
+    const Any argArray[] = {Any::AnyRef(args)..., Any()};
+    return Call(reinterpret_cast<void *>(&object), ArgumentSpan(argArray, sizeof...(Args)));
   }
 
   // Helper to call a const method without having to do casting and manual creation of
-  // the Any types.
+  // the Any types.  The arguments are kept on the stack, so this doesn't allocate.
   template<typename T, typename ...Args>
   Any MethodOverloads::Call(const T &object, Args... args) const
   {
-    return Call(reinterpret_cast<const void *>(&object), {Any::AnyRef(args)...});
+    const Any argArray[] = {Any::AnyRef(args)..., Any()};
+    return Call(reinterpret_cast<const void *>(&object), ArgumentSpan(argArray, sizeof...(Args)));
   }
 
   // Helper to call a static method without having to do casting and manual creation of
-  // the Any types.
+  // the Any types.  The arguments are kept on the stack, so this doesn't allocate.
   template<typename ...Args>
   Any MethodOverloads::CallStatic(Args... args) const
   {
-    return CallStatic({Any::AnyRef(args)...});
+    const Any argArray[] = {Any::AnyRef(args)..., Any()};
+    return CallStatic(ArgumentSpan(argArray, sizeof...(Args)));
   }
 
   ///////////////////////////////////////////////////////////////
@@ -97,27 +195,35 @@ namespace Meta
   ///////////////////////////////////////////////////////////////
 
   // Helper to call a non-const method.  This helps unpack all the Anys in the passed in
-  // vector.
+  // arguments.
   template<typename Class, typename Return, typename ...Args, size_t ...N>
-  Any CallHelper(Class &object, std::function<Return(Class &, Args...)> func, 
-                 const std::vector<Any> &args, VectorUnpack::indicies<N...>)
+  Any CallHelper(Class &object, Return (Class::*func)(Args...), 
+                 ArgumentSpan args, VectorUnpack::indicies<N...>)
   {
-    return func(object, args[N]...);
+    return (object.*func)(args[N]...);
   }
 
   // Constructor for a method.
   template<typename Class, typename Return, typename ...Args>
-  Method_T<Class, Return, Args...>::Method_T(const std::string &name, 
-                                             std::function<Return(Class &, Args...)> func)
-    : Method(name, GET_META(Return), sizeof...(Args), false, false)
+  Method_T<Class, Return, Args...>::Method_T(const std::string &name, Function func)
+    : Method(name, DataStorage<GET_TYPE(Return)>::ReserveData(), sizeof...(Args), false, false)
     , m_Function(func)
   {
     CaptureArgumentMeta<Args...>(m_ArgumentMeta);
+    SetInvoker<Invoker>(&Invoke);
+  }
+
+  // Call the method with its real types.
+  template<typename Class, typename Return, typename ...Args>
+  Return Method_T<Class, Return, Args...>::Invoke(const Method *method, void *object, Args... args)
+  {
+    Function func = static_cast<const Method_T *>(method)->m_Function;
+    return (reinterpret_cast<Class *>(object)->*func)(std::forward<Args>(args)...);
   }
 
   // Call function for a method.
   template<typename Class, typename Return, typename ...Args>
-  Any Method_T<Class, Return, Args...>::Call(void *object, const std::vector<Any> &args) const
+  Any Method_T<Class, Return, Args...>::Call(void *object, ArgumentSpan args) const
   {
     // Call the helper which helps pass all the arguments in order.
     return CallHelper(*reinterpret_cast<Class *>(object), m_Function, args, 
@@ -128,33 +234,43 @@ namespace Meta
   // Method_const_T
   ///////////////////////////////////////////////////////////////
 
-  // Helper to call a const method which unpacks all the arguments in the vector.
+  // Helper to call a const method which unpacks all the arguments in the span.
   template<typename Class, typename Return, typename ...Args, size_t ...N>
-  Any CallHelperConst(const Class &object, std::function<Return(const Class &, Args...)> func, 
-                      const std::vector<Any> &args, VectorUnpack::indicies<N...>)
+  Any CallHelperConst(const Class &object, Return (Class::*func)(Args...) const, 
+                      ArgumentSpan args, VectorUnpack::indicies<N...>)
   {
-    return func(object, args[N]...);
+    return (object.*func)(args[N]...);
   }
 
   // Constructor for a const method.
   template<typename Class, typename Return, typename ...Args>
-  Method_const_T<Class, Return, Args...>::Method_const_T(const std::string &name, std::function<Return(const Class &, Args...)> func)
-    : Method(name, GET_META(Return), sizeof...(Args), false, true)
+  Method_const_T<Class, Return, Args...>::Method_const_T(const std::string &name, Function func)
+    : Method(name, DataStorage<GET_TYPE(Return)>::ReserveData(), sizeof...(Args), false, true)
     , m_Function(func)
   {
     CaptureArgumentMeta<Args...>(m_ArgumentMeta);
+    SetInvoker<Invoker>(&Invoke);
+  }
+
+  // Call the const method with its real types.  It takes the same invoker as a non-const
+  // method, so a handle for a non-const object can call either.
+  template<typename Class, typename Return, typename ...Args>
+  Return Method_const_T<Class, Return, Args...>::Invoke(const Method *method, void *object, Args... args)
+  {
+    Function func = static_cast<const Method_const_T *>(method)->m_Function;
+    return (reinterpret_cast<const Class *>(object)->*func)(std::forward<Args>(args)...);
   }
 
   // Calling a const method with a non-const object.
   template<typename Class, typename Return, typename ...Args>
-  Any Method_const_T<Class, Return, Args...>::Call(void *object, const std::vector<Any> &args) const
+  Any Method_const_T<Class, Return, Args...>::Call(void *object, ArgumentSpan args) const
   {
     return Call(static_cast<const void *>(object), args);
   }
 
   // Call a const method.
   template<typename Class, typename Return, typename ...Args>
-  Any Method_const_T<Class, Return, Args...>::Call(const void *object, const std::vector<Any> &args) const
+  Any Method_const_T<Class, Return, Args...>::Call(const void *object, ArgumentSpan args) const
   {
     // Call the helper which helps pass all the arguments in order.
     return CallHelperConst(*reinterpret_cast<const Class *>(object), m_Function, args, 
@@ -165,9 +281,9 @@ namespace Meta
   // Method_static_T
   ///////////////////////////////////////////////////////////////
 
-  // Helper for a static method to unpack the arguments in the vector in order.
+  // Helper for a static method to unpack the arguments in the span in order.
   template<typename Return, typename ...Args, size_t ...N>
-  Any CallHelperStatic(std::function<Return(Args...)> func, const std::vector<Any> &args, 
+  Any CallHelperStatic(Return (*func)(Args...), ArgumentSpan args, 
                        VectorUnpack::indicies<N...>)
   {
     return func(args[N]...);
@@ -175,16 +291,17 @@ namespace Meta
 
   // Constructor for a static method.
   template<typename Return, typename ...Args>
-  Method_static_T<Return, Args...>::Method_static_T(const std::string &name, std::function<Return(Args...)> func)
-    : Method(name, GET_META(Return), sizeof...(Args), true, false)
+  Method_static_T<Return, Args...>::Method_static_T(const std::string &name, Function func)
+    : Method(name, DataStorage<GET_TYPE(Return)>::ReserveData(), sizeof...(Args), true, false)
     , m_Function(func)
   {
     CaptureArgumentMeta<Args...>(m_ArgumentMeta);
+    SetInvoker<Function>(func);
   }
 
   // Call the static method.
   template<typename Return, typename ...Args>
-  Any Method_static_T<Return, Args...>::CallStatic(const std::vector<Any>& args) const
+  Any Method_static_T<Return, Args...>::CallStatic(ArgumentSpan args) const
   {
     // Call the helper which helps pass all the arguments in order.
     return CallHelperStatic(m_Function, args, 
@@ -199,35 +316,20 @@ namespace Meta
   template<typename Class, typename Return, typename ...Args>
   Method *CreateMethod(const std::string &name, Return (Class::*func)(Args...))
   {
-    auto function = [func](Class &object, Args... args)
-    {
-      return (object.*func)(args...);
-    };
-
-    return new Method_T<Class, Return, Args...>(name, function);
+    return ArenaNew<Method_T<Class, Return, Args...>>(name, func);
   }
 
   // Create a const method.
   template<typename Class, typename Return, typename ...Args>
   Method *CreateMethod(const std::string &name, Return (Class::*func)(Args...) const)
   {
-    auto function = [func](const Class &object, Args... args)
-    {
-      return (object.*func)(args...);
-    };
-
-    return new Method_const_T<Class, Return, Args...>(name, function);
+    return ArenaNew<Method_const_T<Class, Return, Args...>>(name, func);
   }
 
   // Create a static method.
   template<typename Class, typename Return, typename ...Args>
   Method *CreateMethod(const std::string &name, Return (*func)(Args...))
   {
-    auto function = [func](Args... args)
-    {
-      return func(args...);
-    };
-
-    return new Method_static_T<Return, Args...>(name, function);
+    return ArenaNew<Method_static_T<Return, Args...>>(name, func);
   }
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+/*****************************************************************************
+File:   MethodHandle.h
+Author: Alex Troyer
+  A method looked up once and then called with its real argument and return
+  types, without going through Any.
+*****************************************************************************/
+#pragma once
+
+#include "Method.h"
+#include "Meta.h"
+
+namespace Meta
+{
+  // Calls a method with a given signature.  The signature is written like
+  // MethodHandle<int(MyClass &, float)> for a non-const object, or
+  // MethodHandle<int(const MyClass &, float)> for a const one.  It is bound to one
+  // overload once, and only binds if the overload's arguments and return are exactly
+  // those types.  Calling it then passes the arguments straight to the method, with no
+  // Anys, no argument list and no overload search.
+  template<typename Signature>
+  class MethodHandle;
+
+  // Calls a method on a non-const object.  Like calling through the overloads, it binds
+  // to a non-const overload if there is one and a const overload otherwise.
+  template<typename Class, typename Return, typename ...Args>
+  class MethodHandle<Return(Class &, Args...)>
+  {
+  public:
+    typedef Return (*Invoker)(const Method *, void *, Args...);
+
+    MethodHandle() = default;
+    explicit MethodHandle(MethodOverloads *overloads);
+    MethodHandle(const HashedName &name);
+
+    bool IsValid() const;
+    Method *GetMethod() const;
+
+    Return Call(Class &object, Args... args) const;
+
+  private:
+    Method *m_Method = nullptr;
+    Invoker m_Invoker = nullptr;
+  };
+
+  // Calls a const method on a const object.
+  template<typename Class, typename Return, typename ...Args>
+  class MethodHandle<Return(const Class &, Args...)>
+  {
+  public:
+    typedef Return (*Invoker)(const Method *, void *, Args...);
+
+    MethodHandle() = default;
+    explicit MethodHandle(MethodOverloads *overloads);
+    MethodHandle(const HashedName &name);
+
+    bool IsValid() const;
+    Method *GetMethod() const;
+
+    Return Call(const Class &object, Args... args) const;
+
+  private:
+    Method *m_Method = nullptr;
+    Invoker m_Invoker = nullptr;
+  };
+
+  // Calls a static method, written like StaticMethodHandle<int(float)>.  The handle
+  // holds the function pointer itself.
+  template<typename Signature>
+  class StaticMethodHandle;
+
+  template<typename Return, typename ...Args>
+  class StaticMethodHandle<Return(Args...)>
+  {
+  public:
+    typedef Return (*Function)(Args...);
+
+    StaticMethodHandle() = default;
+    explicit StaticMethodHandle(MethodOverloads *overloads);
+
+    bool IsValid() const;
+    Method *GetMethod() const;
+
+    Return Call(Args... args) const;
+
+  private:
+    Method *m_Method = nullptr;
+    Function m_Function = nullptr;
+  };
+}
+
+#include "MethodHandle.hpp"
@@ -0,0 +1,153 @@
+/*****************************************************************************
+File:   MethodHandle.hpp
+Author: Alex Troyer
+  A method looked up once and then called with its real argument and return
+  types, without going through Any.
+*****************************************************************************/
+#pragma once
+
+namespace Meta
+{
+  // Find the overload taking the given argument types and get its invoker if it is
+  // the given type.  This is the only time the signature is checked.
+  template<typename Invoker, typename ...Args>
+  Method *BindMethod(MethodOverloads *overloads, Data *classMeta, bool isStatic, bool isConst,
+                     Invoker &invoker)
+  {
+    invoker = nullptr;
+
+    if(overloads == nullptr || overloads->IsStatic() != isStatic || 
+       (classMeta != nullptr && !classMeta->IsA(overloads->GetOwner())))
+      return nullptr;
+
+    Method *method = overloads->FindMethod({DataStorage<GET_TYPE(Args)>::ReserveData()...}, isConst);
+
+    if(method == nullptr)
+      return nullptr;
+
+    invoker = method->GetInvoker<Invoker>();
+
+    return invoker != nullptr ? method : nullptr;
+  }
+
+  ///////////////////////////////////////////////////////////////
+  // MethodHandle<Return(Class &, Args...)>
+  ///////////////////////////////////////////////////////////////
+
+  // Bind to the overload if the methods belong to the class, and it has the handle's
+  // signature.  If it doesn't bind, the handle isn't valid.
+  template<typename Class, typename Return, typename ...Args>
+  MethodHandle<Return(Class &, Args...)>::MethodHandle(MethodOverloads *overloads)
+  {
+    m_Method = BindMethod<Invoker, Args...>(overloads, GET_META(Class), false, false, m_Invoker);
+  }
+
+  // Look up the method on the class by name and bind to it.
+  template<typename Class, typename Return, typename ...Args>
+  MethodHandle<Return(Class &, Args...)>::MethodHandle(const HashedName &name)
+    : MethodHandle(GET_META(Class)->GetMethod(name))
+  {
+  }
+
+  // See if the handle is bound to a method.
+  template<typename Class, typename Return, typename ...Args>
+  bool MethodHandle<Return(Class &, Args...)>::IsValid() const
+  {
+    return m_Method != nullptr;
+  }
+
+  // Get the method the handle is bound to.
+  template<typename Class, typename Return, typename ...Args>
+  Method *MethodHandle<Return(Class &, Args...)>::GetMethod() const
+  {
+    return m_Method;
+  }
+
+  // Call the method on the object.
+  template<typename Class, typename Return, typename ...Args>
+  Return MethodHandle<Return(Class &, Args...)>::Call(Class &object, Args... args) const
+  {
+    FATAL_ERROR_IF(m_Method == nullptr, "Used a MethodHandle that isn't bound!");
+
+    return m_Invoker(m_Method, reinterpret_cast<void *>(&object), std::forward<Args>(args)...);
+  }
+
+  ///////////////////////////////////////////////////////////////
+  // MethodHandle<Return(const Class &, Args...)>
+  ///////////////////////////////////////////////////////////////
+
+  // Bind to the overload if the methods belong to the class, and it is const and has
+  // the handle's signature.  If it doesn't bind, the handle isn't valid.
+  template<typename Class, typename Return, typename ...Args>
+  MethodHandle<Return(const Class &, Args...)>::MethodHandle(MethodOverloads *overloads)
+  {
+    m_Method = BindMethod<Invoker, Args...>(overloads, GET_META(Class), false, true, m_Invoker);
+  }
+
+  // Look up the method on the class by name and bind to it.
+  template<typename Class, typename Return, typename ...Args>
+  MethodHandle<Return(const Class &, Args...)>::MethodHandle(const HashedName &name)
+    : MethodHandle(GET_META(Class)->GetMethod(name))
+  {
+  }
+
+  // See if the handle is bound to a method.
+  template<typename Class, typename Return, typename ...Args>
+  bool MethodHandle<Return(const Class &, Args...)>::IsValid() const
+  {
+    return m_Method != nullptr;
+  }
+
+  // Get the method the handle is bound to.
+  template<typename Class, typename Return, typename ...Args>
+  Method *MethodHandle<Return(const Class &, Args...)>::GetMethod() const
+  {
+    return m_Method;
+  }
+
+  // Call the method on the object.  Const and non-const methods share an invoker, which
+  // takes the object as non-const, but this only binds to const methods.
+  template<typename Class, typename Return, typename ...Args>
+  Return MethodHandle<Return(const Class &, Args...)>::Call(const Class &object, Args... args) const
+  {
+    FATAL_ERROR_IF(m_Method == nullptr, "Used a MethodHandle that isn't bound!");
+
+    return m_Invoker(m_Method, const_cast<void *>(reinterpret_cast<const void *>(&object)), 
+                     std::forward<Args>(args)...);
+  }
+
+  ///////////////////////////////////////////////////////////////
+  // StaticMethodHandle
+  ///////////////////////////////////////////////////////////////
+
+  // Bind to the overload if the methods are static and it has the handle's signature.
+  // If it doesn't bind, the handle isn't valid.
+  template<typename Return, typename ...Args>
+  StaticMethodHandle<Return(Args...)>::StaticMethodHandle(MethodOverloads *overloads)
+  {
+    m_Method = BindMethod<Function, Args...>(overloads, nullptr, true, false, m_Function);
+  }
+
+  // See if the handle is bound to a method.
+  template<typename Return, typename ...Args>
+  bool StaticMethodHandle<Return(Args...)>::IsValid() const
+  {
+    return m_Method != nullptr;
+  }
+
+  // Get the method the handle is bound to.
+  template<typename Return, typename ...Args>
+  Method *StaticMethodHandle<Return(Args...)>::GetMethod() const
+  {
+    return m_Method;
+  }
+
+  // Call the function.
+  template<typename Return, typename ...Args>
+  Return StaticMethodHandle<Return(Args...)>::Call(Args... args) const
+  {
+    FATAL_ERROR_IF(m_Method == nullptr, "Used a MethodHandle that isn't bound!");
+
+    return m_Function(std::forward<Args>(args)...);
+  }
+}
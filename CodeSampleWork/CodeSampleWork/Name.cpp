@@ -0,0 +1,86 @@
+/*****************************************************************************
+File:   Name.cpp
+Author: Alex Troyer
+  Hashed and interned names so the meta system can look things up by name
+  without building a std::string or hashing it again.
+*****************************************************************************/
+#include "Name.h"
+#include <cstring>
+#include <mutex>
+
+namespace Meta
+{
+  ///////////////////////////////////////////////////////////////
+  // Name
+  ///////////////////////////////////////////////////////////////
+
+  // Intern the given name.
+  Name::Name(const HashedName &name)
+    : m_Entry(NameTable::Intern(name))
+  {
+  }
+
+  // Get the name as a string.  An empty Name gives back an empty string.
+  const std::string &Name::GetString() const
+  {
+    static const std::string empty;
+
+    return m_Entry ? m_Entry->m_String : empty;
+  }
+
+  // Get the name as a const char *
+  const char *Name::GetCStr() const
+  {
+    return GetString().c_str();
+  }
+
+  // Get the hash that was computed when the name was interned.
+  size_t Name::GetHash() const
+  {
+    return m_Entry ? m_Entry->m_Hash : HashString("", 0);
+  }
+
+  // Whether or not this was ever given a name.
+  bool Name::IsEmpty() const
+  {
+    return m_Entry == nullptr;
+  }
+
+
+  ///////////////////////////////////////////////////////////////
+  // NameTable
+  ///////////////////////////////////////////////////////////////
+
+  // Constructed on first use for the same static initialization order reasons as
+  // the NamedMetaStorage map.
+  std::unordered_multimap<size_t, Name::Entry *, PrecomputedHash> *NameTable::m_Names = nullptr;
+
+  // Find the entry for the name, or make one if this is the first time we've seen it.
+  // This locks since names can be interned from more than one thread (registering
+  // types at runtime).  Entries never move, so the Names handed out don't need it.
+  const Name::Entry *NameTable::Intern(const HashedName &name)
+  {
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if(!m_Names)
+      m_Names = new std::unordered_multimap<size_t, Name::Entry *, PrecomputedHash>();
+
+    auto range = m_Names->equal_range(name.GetHash());
+
+    for(auto it = range.first; it != range.second; ++it)
+    {
+      const std::string &str = it->second->m_String;
+
+      if(str.size() == name.GetLength() && std::memcmp(str.data(), name.GetData(), str.size()) == 0)
+      {
+        return it->second;
+      }
+    }
+
+    Name::Entry *entry = new Name::Entry{std::string(name.GetData(), name.GetLength()), name.GetHash()};
+    m_Names->insert({name.GetHash(), entry});
+
+    return entry;
+  }
+}
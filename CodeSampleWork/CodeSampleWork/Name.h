@@ -0,0 +1,141 @@
+/*****************************************************************************
+File:   Name.h
+Author: Alex Troyer
+  Hashed and interned names so the meta system can look things up by name
+  without building a std::string or hashing it again.
+*****************************************************************************/
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <type_traits>
+
+namespace Meta
+{
+  // Name hashes are already computed by the time they are used as a key, so the
+  // maps keyed by them just use the hash as is.
+  struct PrecomputedHash
+  {
+    size_t operator()(size_t hash) const
+    {
+      return hash;
+    }
+  };
+
+  // A name along with its hash.  This doesn't own the characters, so it can be
+  // made from a literal or a std::string without allocating.  Names are hashed when
+  // they are made, except for literals given to META_NAME, which are hashed at
+  // compile time.
+  class HashedName
+  {
+  public:
+    template<size_t N>
+    HashedName(const char (&str)[N]);
+
+    template<size_t Length, size_t Hash>
+    static constexpr HashedName FromLiteral(const char *str);
+
+    // Only takes actual pointers so that a literal picks the array constructor
+    // instead of decaying into a pointer.
+    template<typename Pointer, 
+             typename = typename std::enable_if<std::is_pointer<Pointer>::value &&
+                                                std::is_convertible<Pointer, const char *>::value>::type>
+    HashedName(const Pointer &str);
+
+    HashedName(const std::string &str);
+    HashedName(const char *str, size_t length);
+
+    constexpr const char *GetData() const;
+    constexpr size_t GetLength() const;
+    constexpr size_t GetHash() const;
+
+    bool operator==(const HashedName &rhs) const;
+    bool operator!=(const HashedName &rhs) const;
+
+  private:
+    constexpr HashedName(const char *str, size_t length, size_t hash);
+
+    const char *m_Data;
+    size_t m_Length;
+    size_t m_Hash;
+  };
+
+  // An interned name.  Every Name with the same characters shares one entry, so
+  // comparing two Names is a pointer compare and the hash is never recomputed.
+  class Name
+  {
+  public:
+    friend class NameTable;
+
+    Name() = default;
+    explicit Name(const HashedName &name);
+
+    const std::string &GetString() const;
+    const char *GetCStr() const;
+    size_t GetHash() const;
+    bool IsEmpty() const;
+
+    bool operator==(const Name &rhs) const;
+    bool operator!=(const Name &rhs) const;
+    bool operator==(const HashedName &rhs) const;
+
+  private:
+    struct Entry
+    {
+      std::string m_String;
+      size_t m_Hash;
+    };
+
+    const Entry *m_Entry = nullptr;
+  };
+
+  // Stores the entries for every interned name.  Entries are never freed since
+  // anything holding onto a Name expects it to stay valid.
+  class NameTable
+  {
+  public:
+    static const Name::Entry *Intern(const HashedName &name);
+
+  private:
+    static std::unordered_multimap<size_t, Name::Entry *, PrecomputedHash> *m_Names;
+  };
+
+  // An open addressed map from a name to a pointer.  Lookups take a HashedName so they
+  // never build a string, and the hash is stored next to each entry so a lookup
+  // usually only compares one hash in a flat array.
+  template<typename T>
+  class NameMap
+  {
+  public:
+    T *Find(const HashedName &name) const;
+    bool Insert(const Name &name, T *value);
+    size_t GetCount() const;
+
+  private:
+    struct Slot
+    {
+      size_t m_Hash;
+      Name m_Name;
+      T *m_Value;
+    };
+
+    void Grow();
+
+    std::vector<Slot> m_Slots;
+    size_t m_Count = 0;
+  };
+
+  constexpr size_t HashString(const char *str, size_t length);
+  size_t HashStringRuntime(const char *str, size_t length);
+}
+
+// Hash a string literal into a Meta::HashedName at compile time.  The length and hash
+// are template arguments, so this won't compile for anything that isn't a constant.
+// Give it to GET_META_NAME (or anything else taking a HashedName) for a literal.
+#define META_NAME(literal) \
+Meta::HashedName::FromLiteral<Meta::ArrayStringLength(literal, sizeof(literal)), \
+                              Meta::HashString(literal, Meta::ArrayStringLength(literal, sizeof(literal)))>(literal)
+
+#include "Name.hpp"
@@ -0,0 +1,287 @@
+/*****************************************************************************
+File:   Name.hpp
+Author: Alex Troyer
+  Hashed and interned names so the meta system can look things up by name
+  without building a std::string or hashing it again.
+*****************************************************************************/
+#pragma once
+
+#include <cstring>
+#include <cstdint>
+
+namespace Meta
+{
+  // Seed and multiplier (the 64 bit golden ratio) for HashString.
+  const std::uint64_t HashSeed = 0x27D4EB2F165667C5ULL;
+  const std::uint64_t HashMultiplier = 0x9E3779B97F4A7C15ULL;
+
+  // Read up to 8 characters as a little endian word.
+  constexpr std::uint64_t ReadHashWord(const char *str, size_t length)
+  {
+    return length == 0 ? 0 
+                       : static_cast<std::uint64_t>(static_cast<unsigned char>(*str)) | 
+                         (ReadHashWord(str + 1, length - 1) << 8);
+  }
+
+  // Mix in the string 8 characters at a time.
+  constexpr std::uint64_t HashWords(const char *str, size_t length, std::uint64_t hash)
+  {
+    return length > 8 ? HashWords(str + 8, length - 8, (hash ^ ReadHashWord(str, 8)) * HashMultiplier)
+                      : (hash ^ ReadHashWord(str, length)) * HashMultiplier;
+  }
+
+  // Fold the high bits into the low bits, since the low bits are what pick a slot in a table.
+  constexpr std::uint64_t FinalizeHash(std::uint64_t hash)
+  {
+    return (hash ^ (hash >> 32)) * HashMultiplier ^ (((hash ^ (hash >> 32)) * HashMultiplier) >> 29);
+  }
+
+  // Hash a string.  This has to be written recursively so it can be evaluated at compile
+  // time, so use HashStringRuntime on strings that are only known at runtime.  Both give
+  // the same result.
+  constexpr size_t HashString(const char *str, size_t length)
+  {
+    return static_cast<size_t>(FinalizeHash(HashWords(str, length, HashSeed ^ length)));
+  }
+
+  // The length of a string in a char array.  Stops at the end of the array in case
+  // it isn't null terminated.
+  constexpr size_t ArrayStringLength(const char *str, size_t maxLength)
+  {
+    return (maxLength == 0 || *str == '\0') ? 0 : 1 + ArrayStringLength(str + 1, maxLength - 1);
+  }
+
+  // Same as ArrayStringLength, for arrays that are only known at runtime.
+  inline size_t ArrayStringLengthRuntime(const char *str, size_t maxLength)
+  {
+    const void *end = std::memchr(str, '\0', maxLength);
+    return end != nullptr ? static_cast<size_t>(static_cast<const char *>(end) - str) : maxLength;
+  }
+
+  // Construct from a literal (or any char array).  This is hashed at runtime like any
+  // other string, since the recursive constexpr hash is much slower than the loop when
+  // the compiler doesn't fold it.  META_NAME hashes a literal at compile time instead.
+  template<size_t N>
+  HashedName::HashedName(const char (&str)[N])
+    : HashedName(str, ArrayStringLengthRuntime(str, N))
+  {
+  }
+
+  // Make a name from a literal whose length and hash were worked out by META_NAME.
+  template<size_t Length, size_t Hash>
+  constexpr HashedName HashedName::FromLiteral(const char *str)
+  {
+    return HashedName(str, Length, Hash);
+  }
+
+  // Construct from a name that has already been hashed.
+  constexpr HashedName::HashedName(const char *str, size_t length, size_t hash)
+    : m_Data(str)
+    , m_Length(length)
+    , m_Hash(hash)
+  {
+  }
+
+  // Construct from a null terminated string.
+  template<typename Pointer, typename>
+  HashedName::HashedName(const Pointer &str)
+    : HashedName(str, std::strlen(str))
+  {
+  }
+
+  // Strings only known at runtime are hashed inline, since loading data looks names up
+  // from std::strings and the call would cost about as much as the hash.
+
+  // Construct from a std::string.  The string has to outlive this.
+  inline HashedName::HashedName(const std::string &str)
+    : HashedName(str.c_str(), str.size())
+  {
+  }
+
+  // Construct from a string and its length.
+  inline HashedName::HashedName(const char *str, size_t length)
+    : m_Data(str)
+    , m_Length(length)
+    , m_Hash(HashStringRuntime(str, length))
+  {
+  }
+
+  // Read up to 8 characters as a little endian word, the same as ReadHashWord.
+  // Everything this builds for is little endian, so a whole word can just be copied.
+  // A partial word is put together a byte at a time, which is faster than a memcpy
+  // whose size isn't known.
+  inline std::uint64_t ReadHashWordRuntime(const char *str, size_t length)
+  {
+    std::uint64_t word = 0;
+
+    if(length == 8)
+    {
+      std::memcpy(&word, str, 8);
+      return word;
+    }
+
+    for(size_t i = length; i > 0; --i)
+    {
+      word = (word << 8) | static_cast<unsigned char>(str[i - 1]);
+    }
+
+    return word;
+  }
+
+  // Same hash as HashString, but as a loop for strings we only have at runtime.
+  inline size_t HashStringRuntime(const char *str, size_t length)
+  {
+    std::uint64_t hash = HashSeed ^ length;
+
+    // Mix in whole words while there is more than one word left...
+    while(length > 8)
+    {
+      hash = (hash ^ ReadHashWordRuntime(str, 8)) * HashMultiplier;
+      str += 8;
+      length -= 8;
+    }
+
+    // ...then the last (possibly partial) word.
+    hash = (hash ^ ReadHashWordRuntime(str, length)) * HashMultiplier;
+
+    return static_cast<size_t>(FinalizeHash(hash));
+  }
+
+  // The accessors and compares are inlined since every name lookup goes through them.
+
+  // Get the characters of the name.  These might not be null terminated.
+  constexpr const char *HashedName::GetData() const
+  {
+    return m_Data;
+  }
+
+  // Get the length of the name.
+  constexpr size_t HashedName::GetLength() const
+  {
+    return m_Length;
+  }
+
+  // Get the hash of the name.
+  constexpr size_t HashedName::GetHash() const
+  {
+    return m_Hash;
+  }
+
+  // Check the hash first since it is almost always what tells two names apart.
+  inline bool HashedName::operator==(const HashedName &rhs) const
+  {
+    return m_Hash == rhs.m_Hash && 
+           m_Length == rhs.m_Length && 
+           std::memcmp(m_Data, rhs.m_Data, m_Length) == 0;
+  }
+
+  inline bool HashedName::operator!=(const HashedName &rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  // Interned names are the same if they share the same entry.
+  inline bool Name::operator==(const Name &rhs) const
+  {
+    return m_Entry == rhs.m_Entry;
+  }
+
+  inline bool Name::operator!=(const Name &rhs) const
+  {
+    return m_Entry != rhs.m_Entry;
+  }
+
+  // Compare against a name that hasn't been interned.
+  inline bool Name::operator==(const HashedName &rhs) const
+  {
+    return m_Entry != nullptr &&
+           m_Entry->m_Hash == rhs.GetHash() && 
+           m_Entry->m_String.size() == rhs.GetLength() && 
+           std::memcmp(m_Entry->m_String.data(), rhs.GetData(), rhs.GetLength()) == 0;
+  }
+
+  ///////////////////////////////////////////////////////////////
+  // NameMap
+  ///////////////////////////////////////////////////////////////
+
+  // Find the value with the given name, starting at the slot the hash picks and
+  // walking forward until we find it or hit an empty slot.
+  template<typename T>
+  T *NameMap<T>::Find(const HashedName &name) const
+  {
+    if(m_Slots.empty())
+      return nullptr;
+
+    size_t mask = m_Slots.size() - 1;
+
+    for(size_t i = name.GetHash() & mask; m_Slots[i].m_Value != nullptr; i = (i + 1) & mask)
+    {
+      if(m_Slots[i].m_Hash == name.GetHash() && m_Slots[i].m_Name == name)
+      {
+        return m_Slots[i].m_Value;
+      }
+    }
+
+    return nullptr;
+  }
+
+  // Add a value by name.  If the name is already taken, the first one added wins
+  // and this returns false.
+  template<typename T>
+  bool NameMap<T>::Insert(const Name &name, T *value)
+  {
+    if(Find(HashedName(name.GetString())) != nullptr)
+      return false;
+
+    // Keep the table at most half full so probes stay short.
+    if((m_Count + 1) * 2 > m_Slots.size())
+      Grow();
+
+    size_t mask = m_Slots.size() - 1;
+    size_t i = name.GetHash() & mask;
+
+    while(m_Slots[i].m_Value != nullptr)
+    {
+      i = (i + 1) & mask;
+    }
+
+    m_Slots[i].m_Hash = name.GetHash();
+    m_Slots[i].m_Name = name;
+    m_Slots[i].m_Value = value;
+    ++m_Count;
+
+    return true;
+  }
+
+  // Get how many values are in the map.
+  template<typename T>
+  size_t NameMap<T>::GetCount() const
+  {
+    return m_Count;
+  }
+
+  // Double the size of the table and put everything back in.
+  template<typename T>
+  void NameMap<T>::Grow()
+  {
+    std::vector<Slot> oldSlots(m_Slots.empty() ? 16 : m_Slots.size() * 2, Slot{0, Name(), nullptr});
+    oldSlots.swap(m_Slots);
+
+    size_t mask = m_Slots.size() - 1;
+
+    for(const Slot &slot : oldSlots)
+    {
+      if(slot.m_Value == nullptr)
+        continue;
+
+      size_t i = slot.m_Hash & mask;
+
+      while(m_Slots[i].m_Value != nullptr)
+      {
+        i = (i + 1) & mask;
+      }
+
+      m_Slots[i] = slot;
+    }
+  }
+}
\ No newline at end of file
@@ -5,11 +5,92 @@ Author: Alex Troyer
 *****************************************************************************/
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include "Arena.h"
+#include "SlabPool.h"
+#include "MemoryResource.h"
+
+// Set to 1 (or build with /p:MetaSlabPools=1) to have every type small enough get its
+// own SlabPool, which Construct, Copy, MoveConstruct and Destroy (and so Any) allocate
+// from instead of the global new.  See ObjectInfoBase for what this changes.
+#ifndef META_SLAB_POOLS
+#define META_SLAB_POOLS 0
+#endif
+
 namespace Meta
 {
+  // The size of a cache line on everything this builds for.
+  const size_t CacheLineSize = 64;
+
+  // Plain function pointers for building and destroying objects of a type, along with
+  // what is needed to allocate them.  A copy of this lives in the type's Data so hot 
+  // paths like Any make one indirect call instead of finding the ObjectInfo and going
+  // through its virtual functions.  It is kept small enough to fit in a cache line, and
+  // Data aligns its copy to one.
+  //
+  // A function is null if the type can't do it.  Destroy is also null if the 
+  // destructor doesn't do anything, so it can be skipped.  Equal compares two objects 
+  // with the type's ==, so containers of the type can be compared.
+  struct LifetimeTable
+  {
+    enum Flags : std::uint16_t
+    {
+      HasConstructor = 1 << 0,
+      HasCopyConstructor = 1 << 1,
+      HasMoveConstructor = 1 << 2,
+      HasNothrowMoveConstructor = 1 << 3,
+      HasDestructor = 1 << 4,
+      IsPolymorphic = 1 << 5,
+      IsTriviallyCopyable = 1 << 6,
+      IsTriviallyDestructible = 1 << 7,
+      IsTriviallyRelocatable = 1 << 8
+    };
+
+    typedef void (*ConstructFn)(void *ptr);
+    typedef void (*CopyFn)(void *ptr, const void *object);
+    typedef void (*MoveFn)(void *ptr, void *object);
+    typedef void (*DestroyFn)(void *ptr);
+    typedef void (*RelocateFn)(void *ptr, void *objects, size_t count);
+    typedef bool (*EqualFn)(const void *lhs, const void *rhs);
+
+    bool Has(std::uint16_t flags) const;
+
+    void *Allocate(MemoryResource *resource) const;
+    void Deallocate(void *ptr, MemoryResource *resource) const;
+
+    void *ConstructIn(MemoryResource *resource) const;
+    void *CopyIn(MemoryResource *resource, const void *object) const;
+    void *MoveConstructIn(MemoryResource *resource, void *object) const;
+    void DestroyIn(MemoryResource *resource, void *ptr) const;
+
+    ConstructFn m_Construct = nullptr;
+    CopyFn m_Copy = nullptr;
+    MoveFn m_Move = nullptr;
+    DestroyFn m_Destroy = nullptr;
+    RelocateFn m_Relocate = nullptr;
+    EqualFn m_Equal = nullptr;
+    SlabPool *m_Pool = nullptr;
+    std::uint32_t m_Size = 0;
+    std::uint16_t m_Alignment = 0;
+    std::uint16_t m_Flags = 0;
+  };
+
+  static_assert(sizeof(LifetimeTable) <= CacheLineSize, "LifetimeTable has to fit in a cache line!");
+
+  // The virtual interface to the lifetime of a type.
+  //
+  // A type without a pool makes its objects with new and Destroy calls delete, so
+  // Destroy takes any object made with new, including a child class through its
+  // parent's object info.  A pooled type (only with META_SLAB_POOLS) makes them in its
+  // pool, and Destroy gives them back to it, so it only takes objects made by the same
+  // object info.  Types with virtual functions are never pooled, since they are the 
+  // ones that get destroyed through a parent.
   class ObjectInfoBase
   {
   public:
+    ObjectInfoBase(const LifetimeTable &lifetime);
+
     virtual void *Construct() const = 0;
     virtual void PlacementConstruct(void *) const = 0;
     virtual void *Copy(const void *) const = 0;
@@ -19,11 +100,43 @@ namespace Meta
     virtual void Destroy(void *) const = 0;
     virtual void Destructor(void *) const = 0;
 
+    // Work on arrays of objects next to each other with one call.
+    virtual void ConstructN(void *, size_t) const = 0;
+    virtual void CopyN(void *, const void *, size_t) const = 0;
+    virtual void MoveN(void *, void *, size_t) const = 0;
+    virtual void DestroyN(void *, size_t) const = 0;
+    virtual void RelocateN(void *, void *, size_t) const = 0;
+
     virtual bool HasConstructor() const = 0;
     virtual bool HasCopyConstructor() const = 0;
     virtual bool HasMoveConstructor() const = 0;
+    virtual bool HasNothrowMoveConstructor() const = 0;
     virtual bool HasDestructor() const = 0;
     virtual bool IsPolymorphic() const = 0;
+    virtual bool IsTriviallyCopyable() const = 0;
+    virtual bool IsTriviallyDestructible() const = 0;
+    virtual bool IsTriviallyRelocatable() const = 0;
+    virtual size_t GetAlignment() const = 0;
+
+    // Hash an object with its type's std::hash, if it has one.
+    virtual bool HasHash() const = 0;
+    virtual size_t Hash(const void *) const = 0;
+
+    void *Allocate() const;
+    void Deallocate(void *ptr) const;
+    SlabPool *GetPool() const;
+    const LifetimeTable &GetLifetime() const;
+
+    void *Allocate(MemoryResource *resource) const;
+    void Deallocate(void *ptr, MemoryResource *resource) const;
+
+    void *ConstructIn(MemoryResource *resource) const;
+    void *CopyIn(MemoryResource *resource, const void *object) const;
+    void *MoveConstructIn(MemoryResource *resource, void *object) const;
+    void DestroyIn(MemoryResource *resource, void *ptr) const;
+
+  private:
+    LifetimeTable m_Lifetime;
   };
 }
 
@@ -4,6 +4,14 @@ Author: Alex Troyer
   Stores information on an object like its constructors.
 *****************************************************************************/
 #pragma once
+
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Error.h"
+
 namespace Meta
 {
   // The following functions are decided by taking advantage of Substition Failure
@@ -136,15 +144,481 @@ namespace Meta
   {
   }
 
-  // Now I use the above functions to call inside of the ObjectInfo class.
+  // The following work on arrays of objects next to each other.  Trivially copyable
+  // types are copied and moved with a single memcpy and trivial destructors are skipped,
+  // so there is no loop at all for those.
+
+  // Function to default construct an array of objects in place.
+  template<typename T>
+  void PlacementConstructN(void *ptr, size_t count, typename std::enable_if<std::is_default_constructible<T>::value>::type * = nullptr)
+  {
+    T *objects = reinterpret_cast<T *>(ptr);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+      new (objects + i) T();
+    }
+  }
+
+  // Function to default construct an array of objects that don't have a default constructor.
+  template<typename T>
+  void PlacementConstructN(void *, size_t, typename std::enable_if<!std::is_default_constructible<T>::value>::type * = nullptr)
+  {
+  }
+
+  // Function to copy an array of trivially copyable objects.
+  template<typename T>
+  void PlacementCopyN(void *ptr, const void *objects, size_t count, 
+                      typename std::enable_if<std::is_trivially_copyable<T>::value && 
+                                              std::is_copy_constructible<T>::value>::type * = nullptr)
+  {
+    if(count > 0)
+      std::memcpy(ptr, objects, count * sizeof(T));
+  }
+
+  // Function to copy an array of objects one at a time.
+  template<typename T>
+  void PlacementCopyN(void *ptr, const void *objects, size_t count, 
+                      typename std::enable_if<!std::is_trivially_copyable<T>::value && 
+                                              std::is_copy_constructible<T>::value>::type * = nullptr)
+  {
+    T *destination = reinterpret_cast<T *>(ptr);
+    const T *source = reinterpret_cast<const T *>(objects);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+      new (destination + i) T(source[i]);
+    }
+  }
+
+  // Function to copy an array of objects that don't have a copy constructor.
+  template<typename T>
+  void PlacementCopyN(void *, const void *, size_t, typename std::enable_if<!std::is_copy_constructible<T>::value>::type * = nullptr)
+  {
+  }
+
+  // Function to move an array of trivially copyable objects.
+  template<typename T>
+  void PlacementMoveN(void *ptr, void *objects, size_t count, 
+                      typename std::enable_if<std::is_trivially_copyable<T>::value && 
+                                              std::is_move_constructible<T>::value>::type * = nullptr)
+  {
+    if(count > 0)
+      std::memcpy(ptr, objects, count * sizeof(T));
+  }
+
+  // Function to move an array of objects one at a time.
+  template<typename T>
+  void PlacementMoveN(void *ptr, void *objects, size_t count, 
+                      typename std::enable_if<!std::is_trivially_copyable<T>::value && 
+                                              std::is_move_constructible<T>::value>::type * = nullptr)
+  {
+    T *destination = reinterpret_cast<T *>(ptr);
+    T *source = reinterpret_cast<T *>(objects);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+      new (destination + i) T(std::move(source[i]));
+    }
+  }
+
+  // Function to move an array of objects that don't have a move constructor.
+  template<typename T>
+  void PlacementMoveN(void *, void *, size_t, typename std::enable_if<!std::is_move_constructible<T>::value>::type * = nullptr)
+  {
+  }
+
+  // Function to call the destructor on an array of objects that have a destructor that 
+  // does something.
+  template<typename T>
+  void DestructorN(void *ptr, size_t count, 
+                   typename std::enable_if<std::is_destructible<T>::value && 
+                                           !std::is_trivially_destructible<T>::value>::type * = nullptr)
+  {
+    T *objects = reinterpret_cast<T *>(ptr);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+      objects[i].~T();
+    }
+  }
+
+  // Function to skip destroying an array of objects that are trivially destructible 
+  // (or can't be destroyed).
+  template<typename T>
+  void DestructorN(void *, size_t, 
+                   typename std::enable_if<!std::is_destructible<T>::value || 
+                                           std::is_trivially_destructible<T>::value>::type * = nullptr)
+  {
+  }
+
+  // Function to relocate (move, then destroy what was moved from) an array of trivially
+  // copyable objects.  The arrays can overlap.
+  template<typename T>
+  void RelocateN(void *ptr, void *objects, size_t count, 
+                 typename std::enable_if<std::is_trivially_copyable<T>::value && 
+                                         std::is_move_constructible<T>::value>::type * = nullptr)
+  {
+    if(count > 0)
+      std::memmove(ptr, objects, count * sizeof(T));
+  }
+
+  // Function to relocate an array of objects one at a time.  The arrays can overlap, so 
+  // walk in the direction that never writes over an object before it is moved.
+  template<typename T>
+  void RelocateN(void *ptr, void *objects, size_t count, 
+                 typename std::enable_if<!std::is_trivially_copyable<T>::value && 
+                                         std::is_move_constructible<T>::value>::type * = nullptr)
+  {
+    T *destination = reinterpret_cast<T *>(ptr);
+    T *source = reinterpret_cast<T *>(objects);
+
+    if(destination < source)
+    {
+      for(size_t i = 0; i < count; ++i)
+      {
+        new (destination + i) T(std::move(source[i]));
+        Meta::Destructor<T>(source + i);
+      }
+    }
+    else
+    {
+      for(size_t i = count; i > 0; --i)
+      {
+        new (destination + i - 1) T(std::move(source[i - 1]));
+        Meta::Destructor<T>(source + i - 1);
+      }
+    }
+  }
+
+  // Objects that don't have a move constructor can't be relocated.
+  template<typename T>
+  void RelocateN(void *, void *, size_t, typename std::enable_if<!std::is_move_constructible<T>::value>::type * = nullptr)
+  {
+    FATAL_ERROR("Relocating objects that don't have a move constructor!");
+  }
+
+  // See if two objects of a type can be compared with ==.
+  template<typename T, typename = void>
+  struct HasEqualOperator : std::false_type
+  {
+  };
+
+  template<typename T>
+  struct HasEqualOperator<T, decltype(void(std::declval<const T &>() == std::declval<const T &>()))> : std::true_type
+  {
+  };
+
+  // Function to compare two objects if they have an ==.
+  template<typename T>
+  bool Equal(const void *lhs, const void *rhs, typename std::enable_if<HasEqualOperator<T>::value>::type * = nullptr)
+  {
+    return *reinterpret_cast<const T *>(lhs) == *reinterpret_cast<const T *>(rhs);
+  }
+
+  // Function to compare two objects that don't have an ==.
+  template<typename T>
+  bool Equal(const void *, const void *, typename std::enable_if<!HasEqualOperator<T>::value>::type * = nullptr)
+  {
+    return false;
+  }
+
+  // See if a type has a std::hash.
+  template<typename T, typename = void>
+  struct HasStdHash : std::false_type
+  {
+  };
+
+  template<typename T>
+  struct HasStdHash<T, decltype(void(std::hash<T>()(std::declval<const T &>())))> : std::true_type
+  {
+  };
+
+  // Function to hash an object that has a std::hash.
+  template<typename T>
+  size_t HashObject(const void *object, typename std::enable_if<HasStdHash<T>::value>::type * = nullptr)
+  {
+    return std::hash<T>()(*reinterpret_cast<const T *>(object));
+  }
+
+  // Function to hash an object that doesn't have a std::hash.
+  template<typename T>
+  size_t HashObject(const void *, typename std::enable_if<!HasStdHash<T>::value>::type * = nullptr)
+  {
+    return 0;
+  }
+
+  // Function to get the size of a complete object type.
+  template<typename T>
+  size_t SizeOf(typename std::enable_if<std::is_object<T>::value>::type * = nullptr)
+  {
+    return sizeof(T);
+  }
+
+  // Function to get the size of a type that has none, like void.
+  template<typename T>
+  size_t SizeOf(typename std::enable_if<!std::is_object<T>::value>::type * = nullptr)
+  {
+    return 0;
+  }
+
+  // Function to get the alignment of a complete object type.
+  template<typename T>
+  size_t AlignmentOf(typename std::enable_if<std::is_object<T>::value>::type * = nullptr)
+  {
+    return alignof(T);
+  }
+
+  // Function to get the alignment of a type that has none, like void.
+  template<typename T>
+  size_t AlignmentOf(typename std::enable_if<!std::is_object<T>::value>::type * = nullptr)
+  {
+    return 0;
+  }
+
+  // The following are what the LifetimeTable points at.  They call the functions above
+  // with the exact signatures the table needs.
+
+  template<typename T>
+  void LifetimeConstruct(void *ptr)
+  {
+    Meta::PlacementConstruct<T>(ptr);
+  }
+
+  template<typename T>
+  void LifetimeCopy(void *ptr, const void *object)
+  {
+    Meta::PlacementCopy<T>(ptr, object);
+  }
+
+  template<typename T>
+  void LifetimeMove(void *ptr, void *object)
+  {
+    Meta::PlacementMove<T>(ptr, object);
+  }
+
+  template<typename T>
+  void LifetimeDestroy(void *ptr)
+  {
+    Meta::Destructor<T>(ptr);
+  }
+
+  template<typename T>
+  void LifetimeRelocate(void *ptr, void *objects, size_t count)
+  {
+    Meta::RelocateN<T>(ptr, objects, count);
+  }
+
+  template<typename T>
+  bool LifetimeEqual(const void *lhs, const void *rhs)
+  {
+    return Meta::Equal<T>(lhs, rhs);
+  }
+
+  // Fill out the lifetime table for a type.
+  template<typename T>
+  LifetimeTable MakeLifetimeTable()
+  {
+    LifetimeTable lifetime;
+
+    lifetime.m_Construct = std::is_default_constructible<T>::value ? &LifetimeConstruct<T> : nullptr;
+    lifetime.m_Copy = std::is_copy_constructible<T>::value ? &LifetimeCopy<T> : nullptr;
+    lifetime.m_Move = std::is_move_constructible<T>::value ? &LifetimeMove<T> : nullptr;
+    lifetime.m_Destroy = std::is_destructible<T>::value && !std::is_trivially_destructible<T>::value ? &LifetimeDestroy<T> : nullptr;
+    lifetime.m_Relocate = std::is_move_constructible<T>::value ? &LifetimeRelocate<T> : nullptr;
+    lifetime.m_Equal = HasEqualOperator<T>::value ? &LifetimeEqual<T> : nullptr;
+    lifetime.m_Size = static_cast<std::uint32_t>(Meta::SizeOf<T>());
+    lifetime.m_Alignment = static_cast<std::uint16_t>(Meta::AlignmentOf<T>());
+
+    lifetime.m_Flags = static_cast<std::uint16_t>(
+      (std::is_default_constructible<T>::value ? LifetimeTable::HasConstructor : 0) |
+      (std::is_copy_constructible<T>::value ? LifetimeTable::HasCopyConstructor : 0) |
+      (std::is_move_constructible<T>::value ? LifetimeTable::HasMoveConstructor : 0) |
+      (std::is_nothrow_move_constructible<T>::value ? LifetimeTable::HasNothrowMoveConstructor : 0) |
+      (std::is_destructible<T>::value ? LifetimeTable::HasDestructor : 0) |
+      (std::is_polymorphic<T>::value ? LifetimeTable::IsPolymorphic : 0) |
+      (std::is_trivially_copyable<T>::value ? LifetimeTable::IsTriviallyCopyable : 0) |
+      (std::is_trivially_destructible<T>::value ? LifetimeTable::IsTriviallyDestructible : 0) |
+      (std::is_trivially_copyable<T>::value ? LifetimeTable::IsTriviallyRelocatable : 0));
+
+    return lifetime;
+  }
+
+  ///////////////////////////////////////////////////////////////
+  // LifetimeTable
+  ///////////////////////////////////////////////////////////////
+
+  // See if the type has all of the given flags.
+  inline bool LifetimeTable::Has(std::uint16_t flags) const
+  {
+    return (m_Flags & flags) == flags;
+  }
+
+  // Get memory for one object from the resource.  A null resource means the usual
+  // place, which is the type's pool if it has one or the global new.
+  inline void *LifetimeTable::Allocate(MemoryResource *resource) const
+  {
+    if(resource != nullptr)
+      return resource->Allocate(m_Size, m_Alignment);
+
+    return m_Pool != nullptr ? m_Pool->Allocate() : ::operator new(m_Size);
+  }
+
+  // Give back memory from Allocate to the resource it came from.
+  inline void LifetimeTable::Deallocate(void *ptr, MemoryResource *resource) const
+  {
+    if(resource != nullptr)
+      resource->Deallocate(ptr, m_Size, m_Alignment);
+    else if(m_Pool != nullptr)
+      m_Pool->Deallocate(ptr);
+    else
+      ::operator delete(ptr);
+  }
+
+  // The following construct objects in memory from a resource.  They return null 
+  // (without allocating) if the object can't be constructed that way.
+
+  inline void *LifetimeTable::ConstructIn(MemoryResource *resource) const
+  {
+    if(m_Construct == nullptr)
+      return nullptr;
+
+    void *ptr = Allocate(resource);
+    m_Construct(ptr);
+    return ptr;
+  }
+
+  inline void *LifetimeTable::CopyIn(MemoryResource *resource, const void *object) const
+  {
+    if(m_Copy == nullptr)
+      return nullptr;
+
+    void *ptr = Allocate(resource);
+    m_Copy(ptr, object);
+    return ptr;
+  }
+
+  inline void *LifetimeTable::MoveConstructIn(MemoryResource *resource, void *object) const
+  {
+    if(m_Move == nullptr)
+      return nullptr;
+
+    void *ptr = Allocate(resource);
+    m_Move(ptr, object);
+    return ptr;
+  }
+
+  // Destroy an object made with one of the above and give its memory back to the resource.
+  inline void LifetimeTable::DestroyIn(MemoryResource *resource, void *ptr) const
+  {
+    if(!Has(HasDestructor) || ptr == nullptr)
+      return;
+
+    if(m_Destroy != nullptr)
+      m_Destroy(ptr);
+
+    Deallocate(ptr, resource);
+  }
+
+  ///////////////////////////////////////////////////////////////
+  // ObjectInfoBase
+  ///////////////////////////////////////////////////////////////
+
+  // Give the type a pool if it is small enough to have one and isn't polymorphic.
+  inline ObjectInfoBase::ObjectInfoBase(const LifetimeTable &lifetime)
+    : m_Lifetime(lifetime)
+  {
+  #if META_SLAB_POOLS
+    if(!m_Lifetime.Has(LifetimeTable::IsPolymorphic) && 
+       SlabPool::CanPool(m_Lifetime.m_Size, m_Lifetime.m_Alignment))
+      m_Lifetime.m_Pool = ArenaNew<SlabPool>(m_Lifetime.m_Size, m_Lifetime.m_Alignment);
+  #endif
+  }
+
+  // Get memory for one object, from the pool if the type has one.
+  inline void *ObjectInfoBase::Allocate() const
+  {
+    return m_Lifetime.Allocate(nullptr);
+  }
+
+  // Give back memory from Allocate.
+  inline void ObjectInfoBase::Deallocate(void *ptr) const
+  {
+    m_Lifetime.Deallocate(ptr, nullptr);
+  }
+
+  // Get the pool objects are allocated from, or null if they use the global new.
+  inline SlabPool *ObjectInfoBase::GetPool() const
+  {
+    return m_Lifetime.m_Pool;
+  }
+
+  // Get the function pointers and allocation information of the type.
+  inline const LifetimeTable &ObjectInfoBase::GetLifetime() const
+  {
+    return m_Lifetime;
+  }
+
+  // Get memory for one object from the resource.  A null resource means the usual
+  // place (the pool or the global new).
+  inline void *ObjectInfoBase::Allocate(MemoryResource *resource) const
+  {
+    return m_Lifetime.Allocate(resource);
+  }
+
+  // Give back memory from Allocate to the resource it came from.
+  inline void ObjectInfoBase::Deallocate(void *ptr, MemoryResource *resource) const
+  {
+    m_Lifetime.Deallocate(ptr, resource);
+  }
+
+  // The following construct objects in memory from a resource, the same way Construct, 
+  // Copy and MoveConstruct do with the usual memory.
+
+  inline void *ObjectInfoBase::ConstructIn(MemoryResource *resource) const
+  {
+    return m_Lifetime.ConstructIn(resource);
+  }
+
+  inline void *ObjectInfoBase::CopyIn(MemoryResource *resource, const void *object) const
+  {
+    return m_Lifetime.CopyIn(resource, object);
+  }
+
+  inline void *ObjectInfoBase::MoveConstructIn(MemoryResource *resource, void *object) const
+  {
+    return m_Lifetime.MoveConstructIn(resource, object);
+  }
+
+  inline void ObjectInfoBase::DestroyIn(MemoryResource *resource, void *ptr) const
+  {
+    m_Lifetime.DestroyIn(resource, ptr);
+  }
+
+  // Now I use the above functions to call inside of the ObjectInfo class.  Objects of
+  // a pooled type are built in place in its pool, and everything else uses new and 
+  // delete.
 
   template<typename T>
   class ObjectInfo : public ObjectInfoBase
   {
   public:
+    ObjectInfo()
+      : ObjectInfoBase(Meta::MakeLifetimeTable<T>())
+    {
+    }
+
     virtual void *Construct() const
     {
-      return Meta::Construct<T>();
+      if(GetPool() == nullptr)
+        return Meta::Construct<T>();
+
+      if(!std::is_default_constructible<T>::value)
+        return nullptr;
+
+      void *ptr = Allocate();
+      Meta::PlacementConstruct<T>(ptr);
+      return ptr;
     }
 
     virtual void PlacementConstruct(void *ptr) const
@@ -152,9 +626,17 @@ namespace Meta
       Meta::PlacementConstruct<T>(ptr);
     }
 
-    virtual void *Copy(const void *ptr) const
+    virtual void *Copy(const void *object) const
     {
-      return Meta::Copy<T>(ptr);
+      if(GetPool() == nullptr)
+        return Meta::Copy<T>(object);
+
+      if(!std::is_copy_constructible<T>::value)
+        return nullptr;
+
+      void *ptr = Allocate();
+      Meta::PlacementCopy<T>(ptr, object);
+      return ptr;
     }
 
     virtual void PlacementCopy(void *ptr, const void *object) const
@@ -162,9 +644,17 @@ namespace Meta
       Meta::PlacementCopy<T>(ptr, object);
     }
 
-    virtual void *MoveConstruct(void *ptr) const
+    virtual void *MoveConstruct(void *object) const
     {
-      return Meta::MoveConstruct<T>(ptr);
+      if(GetPool() == nullptr)
+        return Meta::MoveConstruct<T>(object);
+
+      if(!std::is_move_constructible<T>::value)
+        return nullptr;
+
+      void *ptr = Allocate();
+      Meta::PlacementMove<T>(ptr, object);
+      return ptr;
     }
 
     virtual void PlacementMove(void *ptr, void *object) const
@@ -174,7 +664,17 @@ namespace Meta
 
     virtual void Destroy(void *ptr) const
     {
-      Meta::Destroy<T>(ptr);
+      if(!std::is_destructible<T>::value || ptr == nullptr)
+        return;
+
+      if(GetPool() == nullptr)
+      {
+        Meta::Destroy<T>(ptr);
+        return;
+      }
+
+      Meta::Destructor<T>(ptr);
+      Deallocate(ptr);
     }
 
     virtual void Destructor(void *ptr) const
@@ -182,6 +682,31 @@ namespace Meta
       Meta::Destructor<T>(ptr);
     }
 
+    virtual void ConstructN(void *ptr, size_t count) const
+    {
+      Meta::PlacementConstructN<T>(ptr, count);
+    }
+
+    virtual void CopyN(void *ptr, const void *objects, size_t count) const
+    {
+      Meta::PlacementCopyN<T>(ptr, objects, count);
+    }
+
+    virtual void MoveN(void *ptr, void *objects, size_t count) const
+    {
+      Meta::PlacementMoveN<T>(ptr, objects, count);
+    }
+
+    virtual void DestroyN(void *ptr, size_t count) const
+    {
+      Meta::DestructorN<T>(ptr, count);
+    }
+
+    virtual void RelocateN(void *ptr, void *objects, size_t count) const
+    {
+      Meta::RelocateN<T>(ptr, objects, count);
+    }
+
     virtual bool HasConstructor() const
     {
       return std::is_default_constructible<T>::value;
@@ -197,6 +722,11 @@ namespace Meta
       return std::is_move_constructible<T>::value;
     }
 
+    virtual bool HasNothrowMoveConstructor() const
+    {
+      return std::is_nothrow_move_constructible<T>::value;
+    }
+
     virtual bool HasDestructor() const
     {
       return std::is_destructible<T>::value;
@@ -206,5 +736,37 @@ namespace Meta
     {
       return std::is_polymorphic<T>::value;
     }
+
+    virtual bool IsTriviallyCopyable() const
+    {
+      return std::is_trivially_copyable<T>::value;
+    }
+
+    virtual bool IsTriviallyDestructible() const
+    {
+      return std::is_trivially_destructible<T>::value;
+    }
+
+    // The standard doesn't have a trait for this, so only trivially copyable types 
+    // are known to be safe to relocate with memmove.
+    virtual bool IsTriviallyRelocatable() const
+    {
+      return std::is_trivially_copyable<T>::value;
+    }
+
+    virtual size_t GetAlignment() const
+    {
+      return Meta::AlignmentOf<T>();
+    }
+
+    virtual bool HasHash() const
+    {
+      return HasStdHash<T>::value;
+    }
+
+    virtual size_t Hash(const void *object) const
+    {
+      return Meta::HashObject<T>(object);
+    }
   };
 }
\ No newline at end of file
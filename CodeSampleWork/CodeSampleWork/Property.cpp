@@ -19,6 +19,36 @@ namespace Meta
     return Any();
   }
 
+  // Get an Any that references the member in the object, so nothing is copied.  A const
+  // member gives a const reference.  Properties that aren't members compute their 
+  // value, so they still give a copy.
+  Any Property::GetRef(void *object)
+  {
+    if(!HasOffset())
+      return Get(static_cast<const void *>(object));
+
+    void *member = reinterpret_cast<char *>(object) + m_Offset;
+
+    if(m_IsReadOnly)
+      return Any::AnyRef(static_cast<const void *>(member), m_ValueMeta);
+
+    return Any::AnyRef(member, m_ValueMeta);
+  }
+
+  // Get an Any that const references the member in the object.
+  Any Property::GetRef(const void *object)
+  {
+    if(!HasOffset())
+      return Get(object);
+
+    return Any::AnyRef(static_cast<const void *>(reinterpret_cast<const char *>(object) + m_Offset), m_ValueMeta);
+  }
+
+  // Get the value into an object of the value's type, without putting it in an Any.
+  void Property::GetInto(const void *, void *)
+  {
+  }
+
   void Property::Set(void *, const void *)
   {
   }
@@ -35,4 +65,94 @@ namespace Meta
   void Property::Assignment(void *, const void *)
   {
   }
+
+  size_t Property::Hash(const void *)
+  {
+    return 0;
+  }
+
+  // Get the property of count objects that are stride bytes apart, into an array of
+  // values.  The array has to already hold count values of the property's type.
+  // This calls GetInto for each object, so properties that can do better override it.
+  void Property::Gather(const void *base, size_t stride, size_t count, void *out)
+  {
+    const char *object = reinterpret_cast<const char *>(base);
+    char *value = reinterpret_cast<char *>(out);
+    size_t valueSize = m_ValueMeta->GetLifetime().m_Size;
+
+    for(size_t i = 0; i < count; ++i, object += stride, value += valueSize)
+    {
+      GetInto(object, value);
+    }
+  }
+
+  // Set the property of count objects that are stride bytes apart from an array of 
+  // values.  This calls Set for each object, so properties that can do better override it.
+  void Property::Scatter(void *base, size_t stride, size_t count, const void *in)
+  {
+    char *object = reinterpret_cast<char *>(base);
+    const char *value = reinterpret_cast<const char *>(in);
+    size_t valueSize = m_ValueMeta->GetLifetime().m_Size;
+
+    for(size_t i = 0; i < count; ++i, object += stride, value += valueSize)
+    {
+      Set(static_cast<void *>(object), static_cast<const void *>(value));
+    }
+  }
+
+  // Whether or not this is a data member with a known offset in the object.
+  bool Property::HasOffset() const
+  {
+    return m_Offset != InvalidOffset;
+  }
+
+  // Get the size of the member, if this is a data member.
+  size_t Property::GetValueSize() const
+  {
+    return m_ValueSize;
+  }
+
+  // Whether or not the member can be copied with a memcpy.
+  bool Property::IsTriviallyCopyable() const
+  {
+    return m_IsTriviallyCopyable;
+  }
+
+  // Whether or not the member can be compared with a memcmp.  This is only true for
+  // members where equal values always have the same bytes, like integers, enums, and
+  // pointers.  Floats don't count (0.0 == -0.0, and NaN != NaN).
+  bool Property::IsBitwiseComparable() const
+  {
+    return m_IsBitwiseComparable;
+  }
+
+  // Get the type of the property's value.
+  Data *Property::GetValueMeta() const
+  {
+    return m_ValueMeta;
+  }
+
+  // Whether or not setting the property does nothing, like a const member or a 
+  // property with only a get.
+  bool Property::IsReadOnly() const
+  {
+    return m_IsReadOnly;
+  }
+
+  // Record the type of the value and if it can be set.
+  void Property::SetValueType(Data *valueMeta, bool isReadOnly)
+  {
+    m_ValueMeta = valueMeta;
+    m_IsReadOnly = isReadOnly;
+  }
+
+  // Record where a data member lives and how it can be copied.
+  void Property::SetLayout(size_t offset, size_t valueSize, bool isTriviallyCopyable,
+                           bool isBitwiseComparable)
+  {
+    m_Offset = offset;
+    m_ValueSize = valueSize;
+    m_IsTriviallyCopyable = isTriviallyCopyable;
+    m_IsBitwiseComparable = isBitwiseComparable;
+  }
 }
\ No newline at end of file
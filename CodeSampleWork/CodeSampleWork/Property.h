@@ -9,7 +9,9 @@ Author: Alex Troyer
 #include "Any.h"
 #include <type_traits>
 #include <functional>
+#include <cstring>
 #include "Meta.h"
+#include "Hash.h"
 #include "Serializer.h"
 #include "Deserializer.h"
 
@@ -54,10 +56,19 @@ namespace Meta
 
     virtual Any Get(const void *object);
     virtual Any Get();
+    virtual void GetInto(const void *object, void *value);
 
     template<typename T>
     Any Get(const T &object);
 
+    Any GetRef(void *object);
+    Any GetRef(const void *object);
+
+    template<typename T>
+    Any GetRef(T &object);
+    template<typename T>
+    Any GetRef(const T &object);
+
     virtual void Set(void *object, const void *rhs);
     virtual void Set(const void *rhs);
 
@@ -69,9 +80,45 @@ namespace Meta
 
     virtual bool Compare(const void *, const void *);
     virtual void Assignment(void *, const void *);
+    virtual size_t Hash(const void *);
+
+    virtual void Gather(const void *base, size_t stride, size_t count, void *out);
+    virtual void Scatter(void *base, size_t stride, size_t count, const void *in);
+
+    template<typename T, typename Value>
+    void Gather(const T *objects, size_t count, Value *out);
+    template<typename T, typename Value>
+    void Scatter(T *objects, size_t count, const Value *in);
+
+    bool HasOffset() const;
+    size_t GetOffset() const;
+    size_t GetValueSize() const;
+    bool IsTriviallyCopyable() const;
+    bool IsBitwiseComparable() const;
+    Data *GetValueMeta() const;
+    bool IsReadOnly() const;
+
+    static const size_t InvalidOffset = static_cast<size_t>(-1);
+
+  protected:
+    void SetLayout(size_t offset, size_t valueSize, bool isTriviallyCopyable,
+                   bool isBitwiseComparable);
+    void SetValueType(Data *valueMeta, bool isReadOnly);
+
+  private:
+    // Only data members know where they live in the object.
+    size_t m_Offset = InvalidOffset;
+    size_t m_ValueSize = 0;
+    bool m_IsTriviallyCopyable = false;
+    // Whether two members are equal exactly when their bytes are (no floats or padding).
+    bool m_IsBitwiseComparable = false;
+    // The type of the value, and whether or not it is known to never be set.
+    Data *m_ValueMeta = nullptr;
+    bool m_IsReadOnly = false;
   };
 
-  // Property of a class with a get and set, or just a get.
+  // Property of a class with a get and set, or just a get.  These can be any callable,
+  // so they are kept in std::functions.
   template<typename Class, typename GetReturn, typename SetParameter>
   class Property_T : public Property
   {
@@ -82,6 +129,7 @@ namespace Meta
     Property_T(const std::string &name, GetFn get, SetFn set);
 
     virtual Any Get(const void *object);
+    virtual void GetInto(const void *object, void *value);
     virtual void Set(void *object, const void *rhs);
 
     virtual void Serialize(const void *object, Util::Serializer &stream);
@@ -89,13 +137,73 @@ namespace Meta
 
     virtual bool Compare(const void *lhs, const void *rhs);
     virtual void Assignment(void *lhs, const void *rhs);
+    virtual size_t Hash(const void *object);
 
   private:
     GetFn m_Get = nullptr;
     SetFn m_Set = nullptr;
   };
 
-  // Property of a class that is static with a get and set, or just a get.
+  // Property of a class with a get and set method, or just a get.  This keeps the 
+  // method pointers and calls them directly instead of going through a std::function.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  class Property_Method_T : public Property
+  {
+  public:
+    typedef GetReturn (Class::*GetMethod)() const;
+    typedef void (Class::*SetMethod)(const SetParameter);
+
+    Property_Method_T(const std::string &name, GetMethod get, SetMethod set);
+
+    virtual Any Get(const void *object);
+    virtual void GetInto(const void *object, void *value);
+    virtual void Set(void *object, const void *rhs);
+
+    virtual void Serialize(const void *object, Util::Serializer &stream);
+    virtual void Deserialize(void *object, Util::Deserializer &stream);
+
+    virtual bool Compare(const void *lhs, const void *rhs);
+    virtual void Assignment(void *lhs, const void *rhs);
+    virtual size_t Hash(const void *object);
+
+    virtual void Gather(const void *base, size_t stride, size_t count, void *out);
+    virtual void Scatter(void *base, size_t stride, size_t count, const void *in);
+
+  private:
+    GetMethod m_Get = nullptr;
+    SetMethod m_Set = nullptr;
+  };
+
+  // Property for a data member of a class.  This knows the byte offset of the member,
+  // so getting and setting it goes straight to the member instead of through a
+  // std::function, and plain data is just copied.
+  template<typename Class, typename MemberType>
+  class Property_Member_T : public Property
+  {
+  public:
+    Property_Member_T(const std::string &name, MemberType Class::*member);
+
+    virtual Any Get(const void *object);
+    virtual void GetInto(const void *object, void *value);
+    virtual void Set(void *object, const void *rhs);
+
+    virtual void Serialize(const void *object, Util::Serializer &stream);
+    virtual void Deserialize(void *object, Util::Deserializer &stream);
+
+    virtual bool Compare(const void *lhs, const void *rhs);
+    virtual void Assignment(void *lhs, const void *rhs);
+    virtual size_t Hash(const void *object);
+
+    virtual void Gather(const void *base, size_t stride, size_t count, void *out);
+    virtual void Scatter(void *base, size_t stride, size_t count, const void *in);
+
+  private:
+    const MemberType &GetMember(const void *object) const;
+    void SetMember(void *object, const MemberType &rhs) const;
+  };
+
+  // Property of a class that is static with a get and set, or just a get.  These can be
+  // any callable, so they are kept in std::functions.
   template<typename Class, typename GetReturn, typename SetParameter>
   class Property_static_T : public Property
   {
@@ -112,6 +220,40 @@ namespace Meta
     GetFn m_Get = nullptr;
     SetFn m_Set = nullptr;
   }; 
+
+  // Static property with a get and set function, or just a get.  The function pointers
+  // are called directly.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  class Property_static_Function_T : public Property
+  {
+  public:
+    typedef GetReturn (*GetFunction)();
+    typedef void (*SetFunction)(const SetParameter);
+
+    Property_static_Function_T(const std::string &name, GetFunction get, SetFunction set);
+
+    virtual Any Get();
+    virtual void Set(const void *rhs);
+
+  private:
+    GetFunction m_Get = nullptr;
+    SetFunction m_Set = nullptr;
+  };
+
+  // Static property for a static data member of a class.  If the member is const, 
+  // it can't be set.
+  template<typename Class, typename MemberType>
+  class Property_static_Member_T : public Property
+  {
+  public:
+    Property_static_Member_T(const std::string &name, MemberType *member);
+
+    virtual Any Get();
+    virtual void Set(const void *rhs);
+
+  private:
+    MemberType *m_Member = nullptr;
+  };
 }
 
 #include "Property.hpp"
\ No newline at end of file
@@ -23,6 +23,55 @@ namespace Meta
     return Get(reinterpret_cast<const void *>(&object));
   }
 
+  // Get a reference to this property in the object, or its value if it isn't a member.
+  template<typename T>
+  Any Property::GetRef(T &object)
+  {
+    return GetRef(reinterpret_cast<void *>(&object));
+  }
+
+  // Get a const reference to this property in the object, or its value if it isn't 
+  // a member.
+  template<typename T>
+  Any Property::GetRef(const T &object)
+  {
+    return GetRef(reinterpret_cast<const void *>(&object));
+  }
+
+  // Get the property of every object in an array.  The objects have to have this
+  // property and the output has to be its value type, or nothing is written.
+  template<typename T, typename Value>
+  void Property::Gather(const T *objects, size_t count, Value *out)
+  {
+    static_assert(std::is_same<T, GET_TYPE(T)>::value && std::is_same<Value, GET_TYPE(Value)>::value,
+                  "Gather needs arrays of values, not pointers or const objects!");
+
+    bool matches = DataStorage<GET_TYPE(Value)>::ReserveData() == m_ValueMeta && GET_META(T)->IsA(GetMeta());
+    FATAL_ERROR_IF(!matches, "Gathered property '" + GetName() + "' with the wrong types!");
+
+    if(!matches)
+      return;
+
+    Gather(reinterpret_cast<const void *>(objects), sizeof(T), count, reinterpret_cast<void *>(out));
+  }
+
+  // Set the property of every object in an array.  The objects have to have this
+  // property and the input has to be its value type, or nothing is read.
+  template<typename T, typename Value>
+  void Property::Scatter(T *objects, size_t count, const Value *in)
+  {
+    static_assert(std::is_same<T, GET_TYPE(T)>::value && std::is_same<Value, GET_TYPE(Value)>::value,
+                  "Scatter needs arrays of values, not pointers or const objects!");
+
+    bool matches = DataStorage<GET_TYPE(Value)>::ReserveData() == m_ValueMeta && GET_META(T)->IsA(GetMeta());
+    FATAL_ERROR_IF(!matches, "Scattered property '" + GetName() + "' with the wrong types!");
+
+    if(!matches)
+      return;
+
+    Scatter(reinterpret_cast<void *>(objects), sizeof(T), count, reinterpret_cast<const void *>(in));
+  }
+
   // Set data on this property.
   template<typename T, typename U>
   void Property::Set(T &object, const U &rhs)
@@ -37,6 +86,29 @@ namespace Meta
     Set(reinterpret_cast<const void *>(&rhs));
   }
 
+  // Get the byte offset of the member in the object.  This is inlined since member
+  // properties add it to the object on every get and set.
+  inline size_t Property::GetOffset() const
+  {
+    return m_Offset;
+  }
+
+  // Hash the value of a property with its std::hash.
+  template<typename T>
+  size_t HashPropertyValue(const T &value, Data *,
+                           typename std::enable_if<HasStdHash<T>::value>::type * = nullptr)
+  {
+    return std::hash<T>()(value);
+  }
+
+  // Hash the value of a property without a std::hash through its meta data.
+  template<typename T>
+  size_t HashPropertyValue(const T &value, Data *valueMeta,
+                           typename std::enable_if<!HasStdHash<T>::value>::type * = nullptr)
+  {
+    return HashValue(valueMeta, &value);
+  }
+
   ///////////////////////////////////////////////////////////////
   // Property_T
   ///////////////////////////////////////////////////////////////
@@ -49,6 +121,7 @@ namespace Meta
     , m_Get(get)
     , m_Set(set)
   {
+    SetValueType(DataStorage<GET_TYPE(GetReturn)>::ReserveData(), false);
   }
 
   // Get the property.
@@ -60,6 +133,13 @@ namespace Meta
     return any;
   }
 
+  // Get the property into a value.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  void Property_T<Class, GetReturn, SetParameter>::GetInto(const void *object, void *value)
+  {
+    *reinterpret_cast<GET_TYPE(GetReturn) *>(value) = m_Get(*reinterpret_cast<const GET_TYPE(Class) *>(object));
+  }
+
   // Set the property.
   template<typename Class, typename GetReturn, typename SetParameter>
   void Property_T<Class, GetReturn, SetParameter>::Set(void *object, const void *rhs)
@@ -104,6 +184,270 @@ namespace Meta
     m_Set(*class1, m_Get(*class2));
   }
 
+  // Hash the property of an object.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  size_t Property_T<Class, GetReturn, SetParameter>::Hash(const void *object)
+  {
+    return HashPropertyValue<GET_TYPE(GetReturn)>(m_Get(*reinterpret_cast<const Class *>(object)), GetValueMeta());
+  }
+
+  ///////////////////////////////////////////////////////////////
+  // Property_Method_T
+  ///////////////////////////////////////////////////////////////
+
+  // Construct a property from method pointers.  A get only property has a null set.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  Property_Method_T<Class, GetReturn, SetParameter>::Property_Method_T(const std::string &name,
+                                                                       GetMethod get, SetMethod set)
+    : Property(name, GET_META(Class), false)
+    , m_Get(get)
+    , m_Set(set)
+  {
+    SetValueType(DataStorage<GET_TYPE(GetReturn)>::ReserveData(), set == nullptr);
+  }
+
+  // Get the property.  The value returned is moved into the Any.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  Any Property_Method_T<Class, GetReturn, SetParameter>::Get(const void *object)
+  {
+    return Any((reinterpret_cast<const Class *>(object)->*m_Get)());
+  }
+
+  // Get the property into a value.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  void Property_Method_T<Class, GetReturn, SetParameter>::GetInto(const void *object, void *value)
+  {
+    *reinterpret_cast<GET_TYPE(GetReturn) *>(value) = (reinterpret_cast<const Class *>(object)->*m_Get)();
+  }
+
+  // Set the property.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  void Property_Method_T<Class, GetReturn, SetParameter>::Set(void *object, const void *rhs)
+  {
+    if(m_Set != nullptr)
+    {
+      (reinterpret_cast<Class *>(object)->*m_Set)(*reinterpret_cast<const GET_TYPE(SetParameter) *>(rhs));
+    }
+  }
+
+  // Serialize the property.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  void Property_Method_T<Class, GetReturn, SetParameter>::Serialize(const void *object, Util::Serializer &stream)
+  {
+    Util::Write(stream, (reinterpret_cast<const Class *>(object)->*m_Get)());
+  }
+
+  // Deserialize the property.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  void Property_Method_T<Class, GetReturn, SetParameter>::Deserialize(void *object, Util::Deserializer &stream)
+  {
+    GET_TYPE(SetParameter) readValue;
+    Util::Read(stream, readValue);
+    Set(object, &readValue);
+  }
+
+  // Compare two different objects and see if the properties are the same.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  bool Property_Method_T<Class, GetReturn, SetParameter>::Compare(const void *lhs, const void *rhs)
+  {
+    const Class *class1 = reinterpret_cast<const Class *>(lhs);
+    const Class *class2 = reinterpret_cast<const Class *>(rhs);
+
+    return (class1->*m_Get)() == (class2->*m_Get)();
+  }
+
+  // Assign one property from another.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  void Property_Method_T<Class, GetReturn, SetParameter>::Assignment(void *lhs, const void *rhs)
+  {
+    if(m_Set != nullptr)
+    {
+      (reinterpret_cast<Class *>(lhs)->*m_Set)((reinterpret_cast<const Class *>(rhs)->*m_Get)());
+    }
+  }
+
+  // Hash the property of an object.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  size_t Property_Method_T<Class, GetReturn, SetParameter>::Hash(const void *object)
+  {
+    return HashPropertyValue<GET_TYPE(GetReturn)>((reinterpret_cast<const Class *>(object)->*m_Get)(), GetValueMeta());
+  }
+
+  // Call the get method on every object.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  void Property_Method_T<Class, GetReturn, SetParameter>::Gather(const void *base, size_t stride, 
+                                                                 size_t count, void *out)
+  {
+    const char *object = reinterpret_cast<const char *>(base);
+    GET_TYPE(GetReturn) *values = reinterpret_cast<GET_TYPE(GetReturn) *>(out);
+
+    for(size_t i = 0; i < count; ++i, object += stride)
+    {
+      values[i] = (reinterpret_cast<const Class *>(object)->*m_Get)();
+    }
+  }
+
+  // Call the set method on every object.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  void Property_Method_T<Class, GetReturn, SetParameter>::Scatter(void *base, size_t stride, 
+                                                                  size_t count, const void *in)
+  {
+    if(m_Set == nullptr)
+      return;
+
+    char *object = reinterpret_cast<char *>(base);
+    const GET_TYPE(SetParameter) *values = reinterpret_cast<const GET_TYPE(SetParameter) *>(in);
+
+    for(size_t i = 0; i < count; ++i, object += stride)
+    {
+      (reinterpret_cast<Class *>(object)->*m_Set)(values[i]);
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////
+  // Property_Member_T
+  ///////////////////////////////////////////////////////////////
+
+  // Get the byte offset of a member in its class.  This is offsetof for a member
+  // pointer, done on uninitialized storage so the class doesn't need to be constructed.
+  template<typename Class, typename MemberType>
+  size_t GetMemberOffset(MemberType Class::*member)
+  {
+    static typename std::aligned_storage<sizeof(Class), alignof(Class)>::type storage;
+    const Class *object = reinterpret_cast<const Class *>(&storage);
+
+    return reinterpret_cast<const char *>(&(object->*member)) - reinterpret_cast<const char *>(object);
+  }
+
+  // Construct a member property, recording where the member is.
+  template<typename Class, typename MemberType>
+  Property_Member_T<Class, MemberType>::Property_Member_T(const std::string &name, MemberType Class::*member)
+    : Property(name, GET_META(Class), false)
+  {
+    SetLayout(GetMemberOffset(member), sizeof(MemberType), std::is_trivially_copyable<MemberType>::value,
+              std::is_integral<MemberType>::value || std::is_enum<MemberType>::value ||
+              std::is_pointer<MemberType>::value);
+    SetValueType(DataStorage<GET_TYPE(MemberType)>::ReserveData(), std::is_const<MemberType>::value);
+  }
+
+  // Get a reference to the member in the given object.
+  template<typename Class, typename MemberType>
+  const MemberType &Property_Member_T<Class, MemberType>::GetMember(const void *object) const
+  {
+    return *reinterpret_cast<const MemberType *>(reinterpret_cast<const char *>(object) + GetOffset());
+  }
+
+  // Write the member in the given object.  Plain data is copied straight over, and
+  // const members are never written.
+  template<typename Class, typename MemberType>
+  void Property_Member_T<Class, MemberType>::SetMember(void *object, const MemberType &rhs) const
+  {
+    if(std::is_const<MemberType>::value)
+      return;
+
+    void *member = reinterpret_cast<char *>(object) + GetOffset();
+
+    if(std::is_trivially_copyable<MemberType>::value)
+    {
+      std::memcpy(member, &rhs, sizeof(MemberType));
+    }
+    else
+    {
+      *reinterpret_cast<GET_TYPE(MemberType) *>(member) = rhs;
+    }
+  }
+
+  // Get the property.
+  template<typename Class, typename MemberType>
+  Any Property_Member_T<Class, MemberType>::Get(const void *object)
+  {
+    return Any(GetMember(object));
+  }
+
+  // Get the property into a value.
+  template<typename Class, typename MemberType>
+  void Property_Member_T<Class, MemberType>::GetInto(const void *object, void *value)
+  {
+    *reinterpret_cast<GET_TYPE(MemberType) *>(value) = GetMember(object);
+  }
+
+  // Set the property.
+  template<typename Class, typename MemberType>
+  void Property_Member_T<Class, MemberType>::Set(void *object, const void *rhs)
+  {
+    SetMember(object, *reinterpret_cast<const MemberType *>(rhs));
+  }
+
+  // Serialize the property.
+  template<typename Class, typename MemberType>
+  void Property_Member_T<Class, MemberType>::Serialize(const void *object, Util::Serializer &stream)
+  {
+    Util::Write(stream, GetMember(object));
+  }
+
+  // Deserialize the property.
+  template<typename Class, typename MemberType>
+  void Property_Member_T<Class, MemberType>::Deserialize(void *object, Util::Deserializer &stream)
+  {
+    GET_TYPE(MemberType) readValue;
+    Util::Read(stream, readValue);
+    SetMember(object, readValue);
+  }
+
+  // Compare two different objects and see if the members are the same.  This still
+  // uses the member's ==, since comparing the bytes is wrong for floats and padding.
+  template<typename Class, typename MemberType>
+  bool Property_Member_T<Class, MemberType>::Compare(const void *lhs, const void *rhs)
+  {
+    return GetMember(lhs) == GetMember(rhs);
+  }
+
+  // Assign the member from another object's.
+  template<typename Class, typename MemberType>
+  void Property_Member_T<Class, MemberType>::Assignment(void *lhs, const void *rhs)
+  {
+    SetMember(lhs, GetMember(rhs));
+  }
+
+  // Hash the member of an object.
+  template<typename Class, typename MemberType>
+  size_t Property_Member_T<Class, MemberType>::Hash(const void *object)
+  {
+    return HashPropertyValue<GET_TYPE(MemberType)>(GetMember(object), GetValueMeta());
+  }
+
+  // Copy the member out of every object.  This is a plain strided loop the compiler
+  // can unroll or vectorize.
+  template<typename Class, typename MemberType>
+  void Property_Member_T<Class, MemberType>::Gather(const void *base, size_t stride, 
+                                                    size_t count, void *out)
+  {
+    const char *object = reinterpret_cast<const char *>(base) + GetOffset();
+    GET_TYPE(MemberType) *values = reinterpret_cast<GET_TYPE(MemberType) *>(out);
+
+    for(size_t i = 0; i < count; ++i, object += stride)
+    {
+      values[i] = *reinterpret_cast<const MemberType *>(object);
+    }
+  }
+
+  // Copy values into the member of every object.  Const members are never written.
+  template<typename Class, typename MemberType>
+  void Property_Member_T<Class, MemberType>::Scatter(void *base, size_t stride, 
+                                                     size_t count, const void *in)
+  {
+    if(std::is_const<MemberType>::value)
+      return;
+
+    char *object = reinterpret_cast<char *>(base) + GetOffset();
+    const MemberType *values = reinterpret_cast<const MemberType *>(in);
+
+    for(size_t i = 0; i < count; ++i, object += stride)
+    {
+      *reinterpret_cast<GET_TYPE(MemberType) *>(object) = values[i];
+    }
+  }
+
   ///////////////////////////////////////////////////////////////
   // Property_static_T
   ///////////////////////////////////////////////////////////////
@@ -117,6 +461,7 @@ namespace Meta
     , m_Get(get)
     , m_Set(set)
   {
+    SetValueType(DataStorage<GET_TYPE(GetReturn)>::ReserveData(), false);
   }
 
   // Get the property.
@@ -135,6 +480,81 @@ namespace Meta
     m_Set(*reinterpret_cast<const GET_TYPE(SetParameter) *>(rhs));
   }
 
+  ///////////////////////////////////////////////////////////////
+  // Property_static_Function_T
+  ///////////////////////////////////////////////////////////////
+
+  // Construct a static property from function pointers.  A get only property has a null set.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  Property_static_Function_T<Class, GetReturn, SetParameter>::Property_static_Function_T(const std::string &name,
+                                                                                         GetFunction get,
+                                                                                         SetFunction set)
+    : Property(name, GET_META(Class), true)
+    , m_Get(get)
+    , m_Set(set)
+  {
+    SetValueType(DataStorage<GET_TYPE(GetReturn)>::ReserveData(), set == nullptr);
+  }
+
+  // Get the property.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  Any Property_static_Function_T<Class, GetReturn, SetParameter>::Get()
+  {
+    return Any(m_Get());
+  }
+
+  // Set the property.
+  template<typename Class, typename GetReturn, typename SetParameter>
+  void Property_static_Function_T<Class, GetReturn, SetParameter>::Set(const void *rhs)
+  {
+    if(m_Set != nullptr)
+    {
+      m_Set(*reinterpret_cast<const GET_TYPE(SetParameter) *>(rhs));
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////
+  // Property_static_Member_T
+  ///////////////////////////////////////////////////////////////
+
+  // If the member is const, it can't be set.
+  template<typename MemberType>
+  void SetStaticMember(MemberType *, const MemberType &, 
+                       typename std::enable_if<std::is_const<MemberType>::value>::type * = nullptr)
+  {
+  }
+
+  // If the member is not const, assign it.
+  template<typename MemberType>
+  void SetStaticMember(MemberType *member, const MemberType &rhs,
+                       typename std::enable_if<!std::is_const<MemberType>::value>::type * = nullptr)
+  {
+    *member = rhs;
+  }
+
+  // Construct a static property from a pointer to a static member.
+  template<typename Class, typename MemberType>
+  Property_static_Member_T<Class, MemberType>::Property_static_Member_T(const std::string &name, MemberType *member)
+    : Property(name, GET_META(Class), true)
+    , m_Member(member)
+  {
+    SetValueType(DataStorage<GET_TYPE(MemberType)>::ReserveData(), std::is_const<MemberType>::value);
+  }
+
+  // Get the property.
+  template<typename Class, typename MemberType>
+  Any Property_static_Member_T<Class, MemberType>::Get()
+  {
+    return Any(*m_Member);
+  }
+
+  // Set the property.
+  template<typename Class, typename MemberType>
+  void Property_static_Member_T<Class, MemberType>::Set(const void *rhs)
+  {
+    SetStaticMember<MemberType>(m_Member, *reinterpret_cast<const MemberType *>(rhs));
+  }
+
   ///////////////////////////////////////////////////////////////
   // Property Creation
   ///////////////////////////////////////////////////////////////
@@ -145,7 +565,7 @@ namespace Meta
                                                              typename Property_T<Class, GetReturn, SetParameter>::GetFn get,
                                                              typename Property_T<Class, GetReturn, SetParameter>::SetFn set)
   {
-    return new Property_T<Class, GetReturn, SetParameter>(name, get, set);
+    return ArenaNew<Property_T<Class, GetReturn, SetParameter>>(name, get, set);
   }
 
   // Create a property with only a get.
@@ -157,88 +577,32 @@ namespace Meta
     {
     };
 
-    return new Property_T<Class, GetReturn, const GetReturn &>(name, get, setFn);
+    return ArenaNew<Property_T<Class, GetReturn, const GetReturn &>>(name, get, setFn);
   }
 
   // Create a property from method pointers.
   template<typename Class, typename GetReturn, typename SetParameter>
-  Property_T<Class, GetReturn, SetParameter> *CreateProperty(const std::string &name,
-                                                             GetReturn (Class::*get)() const,
-                                                             void (Class::*set)(const SetParameter))
+  Property_Method_T<Class, GetReturn, SetParameter> *CreateProperty(const std::string &name,
+                                                                    GetReturn (Class::*get)() const,
+                                                                    void (Class::*set)(const SetParameter))
   {
-    // Wrap the get and set methods into std::functions
-
-    Property_T<Class, GetReturn, SetParameter>::GetFn getFn = 
-      [get](const Class &c)
-    {
-      return (c.*get)();
-    };
-  
-    Property_T<Class, GetReturn, SetParameter>::SetFn setFn = 
-      [set](Class &c, const SetParameter rhs)
-    {
-      (c.*set)(rhs);
-    };
-  
-    return new Property_T<Class, GetReturn, SetParameter>(name, getFn, setFn);
+    return ArenaNew<Property_Method_T<Class, GetReturn, SetParameter>>(name, get, set);
   }
 
   // Creates a property from method pointers with only a get method.
   template<typename Class, typename GetReturn>
-  Property_T<Class, GetReturn, typename const GET_TYPE(GetReturn) &> *CreateProperty(const std::string &name,
-                                                             GetReturn(Class::*get)() const)
-  {
-    // Create the get function.
-    Property_T<Class, GetReturn, const GET_TYPE(GetReturn) &>::GetFn getFn =
-      [get](const Class &c)
-    {
-      return (c.*get)();
-    };
-
-    // Create an empty set function.
-    Property_T<Class, GetReturn, const GET_TYPE(GetReturn) &>::SetFn setFn =
-      [](Class &, typename const GET_TYPE(GetReturn) &)
-    {
-    };
-
-    return new Property_T<Class, GetReturn, const GET_TYPE(GetReturn) &>(name, getFn, setFn);
-  }
-
-  // This will generate a set function that does nothing if the member is const.
-  template<typename Class, typename MemberType>
-  std::function<void (Class &, const MemberType &)> 
-    GetSetFunc(MemberType Class::*,
-               typename std::enable_if<std::is_const<MemberType>::value>::type * = nullptr)
+  Property_Method_T<Class, GetReturn, typename const GET_TYPE(GetReturn) &> *CreateProperty(const std::string &name,
+                                                                    GetReturn(Class::*get)() const)
   {
-    return [](Class &, const MemberType &){};
+    return ArenaNew<Property_Method_T<Class, GetReturn, const GET_TYPE(GetReturn) &>>(name, get, nullptr);
   }
 
-  // This will generate a set function for a member.
+  // Create a property from a member pointer.  If the member is const, it can't be set.
   template<typename Class, typename MemberType>
-  std::function<void(Class &, const MemberType &)>
-    GetSetFunc(MemberType Class::*member,
-               typename std::enable_if<!std::is_const<MemberType>::value>::type * = nullptr)
+  Property_Member_T<Class, MemberType> *CreateProperty(const std::string &name,
+                                                       MemberType Class::*member)
   {
-    return [member](Class &lhs, const MemberType &rhs) 
-    {
-      (lhs.*member) = rhs;
-    };
-  }
-
-  // Create a property from a member pointer.
-  template<typename Class, typename MemberType>
-  Property_T<Class, MemberType, const MemberType &> *CreateProperty(const std::string &name,
-                                                                    MemberType Class::*member)
-  {
-    auto getFn = [member](const Class &c)
-    {
-      return (c.*member);
-    };
-
-    // If the member is const, we will get an empty set function.
-    auto setFn = GetSetFunc<Class, MemberType>(member);
-
-    return new Property_T<Class, MemberType, const MemberType &>(name, getFn, setFn);
+    return ArenaNew<Property_Member_T<Class, MemberType>>(name, member);
   }
 
   // Create a static property using std::function.
@@ -247,7 +611,7 @@ namespace Meta
                                                                     typename Property_static_T<Class, GetReturn, SetParameter>::GetFn get,
                                                                     typename Property_static_T<Class, GetReturn, SetParameter>::SetFn set)
   {
-    return new Property_static_T<Class, GetReturn, SetParameter>(name, get, set);
+    return ArenaNew<Property_static_T<Class, GetReturn, SetParameter>>(name, get, set);
   }
 
   // Create a static property using std::function with only a get function.
@@ -259,79 +623,32 @@ namespace Meta
     {
     };
 
-    return new Property_static_T<Class, GetReturn, typename const GET_TYPE(GetReturn) &>(name, get, set);
+    return ArenaNew<Property_static_T<Class, GetReturn, typename const GET_TYPE(GetReturn) &>>(name, get, set);
   }
 
   // Get a get and set from a static method (or a global function would work here too).
   template<typename Class, typename GetReturn, typename SetParameter>
-  Property_static_T<Class, GetReturn, SetParameter> *CreateProperty(const std::string &name,
-                                                                    GetReturn (*get)(),
-                                                                    void (*set)(const SetParameter))
+  Property_static_Function_T<Class, GetReturn, SetParameter> *CreateProperty(const std::string &name,
+                                                                             GetReturn (*get)(),
+                                                                             void (*set)(const SetParameter))
   {
-    auto getFn = [get]()
-    {
-      return get();
-    };
-
-    auto setFn = [set](const SetParameter rhs)
-    {
-      set(rhs);
-    };
-
-    return new Property_static_T<Class, GetReturn, SetParameter>(name, getFn, setFn);
+    return ArenaNew<Property_static_Function_T<Class, GetReturn, SetParameter>>(name, get, set);
   }
 
   // Create a static property with only a get from a static method or global function.
   template<typename Class, typename GetReturn>
-  Property_static_T<Class, GetReturn, typename const GET_TYPE(GetReturn) &> *CreateProperty(const std::string &name,
-                                                                                            GetReturn(*get)())
+  Property_static_Function_T<Class, GetReturn, typename const GET_TYPE(GetReturn) &> *CreateProperty(const std::string &name,
+                                                                                                     GetReturn(*get)())
   {
-    auto getFn = [get]()
-    {
-      return get();
-    };
-
-    auto setFn = [](const GET_TYPE(GetReturn) &)
-    {
-    };
-
-    return new Property_static_T<Class, GetReturn, const GET_TYPE(GetReturn) &>(name, getFn, setFn);
+    return ArenaNew<Property_static_Function_T<Class, GetReturn, const GET_TYPE(GetReturn) &>>(name, get, nullptr);
   }
 
-  // If the member is const, return an empty set function.
-  template<typename MemberType>
-  std::function<void(const MemberType &rhs)> GetSetFuncStatic(MemberType *,
-                                                              typename std::enable_if<std::is_const<MemberType>::value>::type * = nullptr)
-  {
-    return [](const MemberType &) {};
-  }
-
-  // If the member is not const, return a set function.
-  template<typename MemberType>
-  std::function<void(const MemberType &rhs)> GetSetFuncStatic(MemberType *member,
-                                                              typename std::enable_if<!std::is_const<MemberType>::value>::type * = nullptr)
-  {
-    return [member](const MemberType &rhs) 
-    {
-      *member = rhs;
-    };
-  }
-
-  // Create a static property from a member pointer.
+  // Create a static property from a pointer to a static member.
   template<typename Class, typename MemberType>
-  Property_static_T<Class, MemberType, const MemberType &> *CreateProperty(const std::string &name,
-                                                                           MemberType *member)
+  Property_static_Member_T<Class, MemberType> *CreateProperty(const std::string &name,
+                                                              MemberType *member)
   {
-    auto getFn = [member]()
-    {
-      return *member;
-    };
-
-    // Get the set function for this member.  If it is a const member, the set function
-    // will be empty.
-    auto setFn = GetSetFuncStatic<MemberType>(member);
-
-    return new Property_static_T<Class, MemberType, const MemberType &>(name, getFn, setFn);
+    return ArenaNew<Property_static_Member_T<Class, MemberType>>(name, member);
   }
 }
 
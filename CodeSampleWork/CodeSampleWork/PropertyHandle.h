@@ -0,0 +1,57 @@
+/*****************************************************************************
+File:   PropertyHandle.h
+Author: Alex Troyer
+  A property looked up once and then read and written as the type it really
+  is, without going through Any.
+*****************************************************************************/
+#pragma once
+
+#include "Property.h"
+#include <type_traits>
+
+namespace Meta
+{
+  // Reads and writes a property of any object as the given value type.  It is bound 
+  // to a property once, and only binds if the property's value is that type.  Data 
+  // members are read and written straight through their offset.  Everything else 
+  // calls the property, but still doesn't put the value in an Any.  The value has to
+  // be the type itself, since the meta data of a pointer is that of what it points to.
+  template<typename Value>
+  class PropertyValueHandle
+  {
+    static_assert(std::is_same<Value, GET_TYPE(Value)>::value, "A PropertyHandle's value can't be a pointer, reference or const!");
+
+  public:
+    PropertyValueHandle() = default;
+    explicit PropertyValueHandle(Property *property);
+
+    bool IsValid() const;
+    Property *GetProperty() const;
+
+    Value Get(const void *object) const;
+    void Set(void *object, const Value &value) const;
+
+  private:
+    Property *m_Property = nullptr;
+    size_t m_Offset = Property::InvalidOffset;
+    bool m_IsReadOnly = true;
+  };
+
+  // Reads and writes a property of a given class as the given value type.  This also
+  // checks that the property belongs to the class (or one of its parents).
+  template<typename Class, typename Value>
+  class PropertyHandle : public PropertyValueHandle<Value>
+  {
+    static_assert(std::is_same<Class, GET_TYPE(Class)>::value, "A PropertyHandle's class can't be a pointer, reference or const!");
+
+  public:
+    PropertyHandle() = default;
+    explicit PropertyHandle(Property *property);
+    PropertyHandle(const HashedName &name);
+
+    Value Get(const Class &object) const;
+    void Set(Class &object, const Value &value) const;
+  };
+}
+
+#include "PropertyHandle.hpp"
@@ -0,0 +1,106 @@
+/*****************************************************************************
+File:   PropertyHandle.hpp
+Author: Alex Troyer
+  A property looked up once and then read and written as the type it really
+  is, without going through Any.
+*****************************************************************************/
+#pragma once
+
+namespace Meta
+{
+  ///////////////////////////////////////////////////////////////
+  // PropertyValueHandle
+  ///////////////////////////////////////////////////////////////
+
+  // Bind to the property if its value is the handle's type.  Static properties don't
+  // have an object to read from, so they never bind.  If it doesn't bind, the handle
+  // isn't valid.
+  template<typename Value>
+  PropertyValueHandle<Value>::PropertyValueHandle(Property *property)
+  {
+    if(property == nullptr || property->IsStatic() || 
+       property->GetValueMeta() != DataStorage<GET_TYPE(Value)>::ReserveData())
+      return;
+
+    m_Property = property;
+    m_Offset = property->GetOffset();
+    m_IsReadOnly = property->IsReadOnly();
+  }
+
+  // See if the handle is bound to a property.
+  template<typename Value>
+  bool PropertyValueHandle<Value>::IsValid() const
+  {
+    return m_Property != nullptr;
+  }
+
+  // Get the property the handle is bound to.
+  template<typename Value>
+  Property *PropertyValueHandle<Value>::GetProperty() const
+  {
+    return m_Property;
+  }
+
+  // Get the value of the property on the object.
+  template<typename Value>
+  Value PropertyValueHandle<Value>::Get(const void *object) const
+  {
+    FATAL_ERROR_IF(m_Property == nullptr, "Used a PropertyHandle that isn't bound!");
+
+    if(m_Offset != Property::InvalidOffset)
+      return *reinterpret_cast<const Value *>(reinterpret_cast<const char *>(object) + m_Offset);
+
+    Value value;
+    m_Property->GetInto(object, &value);
+    return value;
+  }
+
+  // Set the value of the property on the object.  Read only properties aren't changed.
+  // The value is passed as a const void * so the untyped Set is called instead of the
+  // template.
+  template<typename Value>
+  void PropertyValueHandle<Value>::Set(void *object, const Value &value) const
+  {
+    FATAL_ERROR_IF(m_Property == nullptr, "Used a PropertyHandle that isn't bound!");
+
+    if(m_IsReadOnly)
+      return;
+
+    if(m_Offset != Property::InvalidOffset)
+      *reinterpret_cast<Value *>(reinterpret_cast<char *>(object) + m_Offset) = value;
+    else
+      m_Property->Set(object, static_cast<const void *>(&value));
+  }
+
+  ///////////////////////////////////////////////////////////////
+  // PropertyHandle
+  ///////////////////////////////////////////////////////////////
+
+  // Bind to the property if it belongs to the class and its value is the handle's type.
+  template<typename Class, typename Value>
+  PropertyHandle<Class, Value>::PropertyHandle(Property *property)
+    : PropertyValueHandle<Value>(property != nullptr && GET_META(Class)->IsA(property->GetMeta()) ? property : nullptr)
+  {
+  }
+
+  // Look up the property on the class by name and bind to it.
+  template<typename Class, typename Value>
+  PropertyHandle<Class, Value>::PropertyHandle(const HashedName &name)
+    : PropertyHandle(GET_META(Class)->GetProperty(name))
+  {
+  }
+
+  // Get the value of the property on the object.
+  template<typename Class, typename Value>
+  Value PropertyHandle<Class, Value>::Get(const Class &object) const
+  {
+    return PropertyValueHandle<Value>::Get(reinterpret_cast<const void *>(&object));
+  }
+
+  // Set the value of the property on the object.
+  template<typename Class, typename Value>
+  void PropertyHandle<Class, Value>::Set(Class &object, const Value &value) const
+  {
+    PropertyValueHandle<Value>::Set(reinterpret_cast<void *>(&object), value);
+  }
+}
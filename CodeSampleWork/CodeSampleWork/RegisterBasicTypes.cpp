@@ -6,8 +6,10 @@ Author: Alex Troyer
 #include "Meta.h"
 #include <string>
 
+// Meta::BasicTypes lists these too, so keep the two in sync.
+
 // Macro tries to take sizeof void so I have to do it this way...
-Meta::SimpleRegisterMetaData<void> Meta::SimpleRegister<void>::m_Register("void", 0, new Meta::ObjectInfo<void>());
+Meta::SimpleRegisterMetaData<void> Meta::SimpleRegister<void>::m_Register("void", 0, Meta::ArenaNew<Meta::ObjectInfo<void>>());
 DEFINE_SIMPLE_TYPE(int);
 DEFINE_SIMPLE_TYPE_NAME("u_int", unsigned int);
 DEFINE_SIMPLE_TYPE(bool);
@@ -24,7 +24,7 @@ namespace Util
 
     const Meta::OrderedVector &orderedData = meta->GetOrderedData();
 
-    for(const std::shared_ptr<Meta::DataInfo> &dataInfo : orderedData)
+    for(Meta::DataInfo *dataInfo : orderedData)
     {
       // Serialize the property if we marked so.
       if(dataInfo->IsSerializable())
@@ -0,0 +1,209 @@
+/*****************************************************************************
+File:   SlabPool.cpp
+Author: Alex Troyer
+  A pool of fixed size blocks for objects of one type, with a free list per 
+  thread.
+*****************************************************************************/
+#include "SlabPool.h"
+#include <vector>
+#include <new>
+
+namespace Meta
+{
+  // Every thread's free lists, indexed by pool.
+  struct SlabPool::ThreadCache
+  {
+    std::vector<FreeList> m_Lists;
+  };
+
+  // Gives a thread's blocks back to the shared lists when the thread ends so other
+  // threads can use them.  Pools are never destroyed, so they are still around for
+  // this.  The cache itself is a plain pointer so it can still be checked after this
+  // runs, since objects can be freed by static destructors after thread locals are gone.
+  struct SlabPool::ThreadCacheOwner
+  {
+    ~ThreadCacheOwner()
+    {
+      ThreadCache *cache = s_ThreadCache;
+
+      if(cache == nullptr)
+        return;
+
+      for(FreeList &list : cache->m_Lists)
+      {
+        if(list.m_Pool != nullptr)
+          list.m_Pool->Release(list, list.m_Count);
+      }
+
+      delete cache;
+      s_ThreadCache = nullptr;
+      s_ThreadCacheDestroyed = true;
+    }
+
+    // Set when the cache is made, which makes sure this thread's owner gets constructed.
+    bool m_IsOwning = false;
+  };
+
+  std::atomic<size_t> SlabPool::s_PoolCount(0);
+  thread_local SlabPool::ThreadCache *SlabPool::s_ThreadCache = nullptr;
+  thread_local bool SlabPool::s_ThreadCacheDestroyed = false;
+  thread_local SlabPool::ThreadCacheOwner SlabPool::s_ThreadCacheOwner;
+
+  // Blocks have to hold a free list pointer and keep every object in them aligned.
+  SlabPool::SlabPool(size_t objectSize, size_t alignment)
+    : m_Index(s_PoolCount.fetch_add(1))
+  {
+    if(alignment < alignof(Block))
+      alignment = alignof(Block);
+
+    if(objectSize < sizeof(Block))
+      objectSize = sizeof(Block);
+
+    m_BlockSize = (objectSize + alignment - 1) & ~(alignment - 1);
+  }
+
+  // Get a block from this thread's free list, refilling it if it's empty.
+  void *SlabPool::Allocate()
+  {
+    FreeList *list = GetThreadFreeList();
+
+    // The thread is ending, so take one block straight from the shared list.
+    if(list == nullptr)
+    {
+      FreeList single;
+      Refill(single, 1);
+      return single.m_Head;
+    }
+
+    if(list->m_Head == nullptr)
+      Refill(*list, BatchSize);
+
+    Block *block = list->m_Head;
+    list->m_Head = block->m_Next;
+    --list->m_Count;
+
+    return block;
+  }
+
+  // Put the block on this thread's free list.  If the list has gotten long, hand a 
+  // batch back to the shared list so one thread freeing what another allocates 
+  // doesn't hoard all the memory.
+  void SlabPool::Deallocate(void *ptr)
+  {
+    Block *block = static_cast<Block *>(ptr);
+    FreeList *list = GetThreadFreeList();
+
+    // The thread is ending, so put the block straight on the shared list.
+    if(list == nullptr)
+    {
+      FreeList single;
+      single.m_Head = block;
+      single.m_Count = 1;
+      block->m_Next = nullptr;
+      Release(single, 1);
+      return;
+    }
+
+    block->m_Next = list->m_Head;
+    list->m_Head = block;
+    ++list->m_Count;
+
+    if(list->m_Count >= BatchSize * 2)
+      Release(*list, BatchSize);
+  }
+
+  // Get the size of the blocks handed out.
+  size_t SlabPool::GetBlockSize() const
+  {
+    return m_BlockSize;
+  }
+
+  // Get how many slabs have been allocated.
+  size_t SlabPool::GetSlabCount() const
+  {
+    return m_SlabCount.load(std::memory_order_relaxed);
+  }
+
+  // See if a type can be pooled.  Slabs come from the global new, which only 
+  // guarantees max_align_t alignment.
+  bool SlabPool::CanPool(size_t objectSize, size_t alignment)
+  {
+    return objectSize > 0 && 
+           objectSize <= MaxObjectSize && 
+           alignment <= alignof(std::max_align_t);
+  }
+
+  // Get this thread's free list for this pool, making room for it the first time.
+  // Returns null if the thread's cache has already been torn down.
+  SlabPool::FreeList *SlabPool::GetThreadFreeList()
+  {
+    ThreadCache *cache = s_ThreadCache;
+
+    if(cache == nullptr)
+    {
+      if(s_ThreadCacheDestroyed)
+        return nullptr;
+
+      cache = new ThreadCache();
+      s_ThreadCache = cache;
+      s_ThreadCacheOwner.m_IsOwning = true;
+    }
+
+    if(m_Index >= cache->m_Lists.size())
+      cache->m_Lists.resize(m_Index + 1);
+
+    FreeList &list = cache->m_Lists[m_Index];
+    list.m_Pool = this;
+
+    return &list;
+  }
+
+  // Move blocks to a thread's free list, from the shared list if it has 
+  // any, otherwise from the current slab.
+  void SlabPool::Refill(FreeList &list, size_t count)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+      Block *block = m_Free;
+
+      if(block != nullptr)
+      {
+        m_Free = block->m_Next;
+      }
+      else
+      {
+        if(m_SlabCurrent == nullptr || m_SlabCurrent + m_BlockSize > m_SlabEnd)
+        {
+          m_SlabCurrent = static_cast<char *>(::operator new(SlabSize));
+          m_SlabEnd = m_SlabCurrent + SlabSize;
+          m_SlabCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        block = reinterpret_cast<Block *>(m_SlabCurrent);
+        m_SlabCurrent += m_BlockSize;
+      }
+
+      block->m_Next = list.m_Head;
+      list.m_Head = block;
+      ++list.m_Count;
+    }
+  }
+
+  // Move some blocks from a thread's free list back to the shared list.
+  void SlabPool::Release(FreeList &list, size_t count)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    for(size_t i = 0; i < count && list.m_Head != nullptr; ++i)
+    {
+      Block *block = list.m_Head;
+      list.m_Head = block->m_Next;
+      --list.m_Count;
+
+      block->m_Next = m_Free;
+      m_Free = block;
+    }
+  }
+}
@@ -0,0 +1,77 @@
+/*****************************************************************************
+File:   SlabPool.h
+Author: Alex Troyer
+  A pool of fixed size blocks for objects of one type, with a free list per 
+  thread.
+*****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+
+namespace Meta
+{
+  // Hands out blocks big enough for one object of a type.  Blocks are carved out of
+  // large slabs that are never given back, and freed blocks go on a free list for the
+  // thread that freed them, so most allocations and frees don't take a lock.  Blocks 
+  // move between the thread free lists and a shared one in batches.
+  class SlabPool
+  {
+  public:
+    // Types bigger than this, or that need more alignment than max_align_t, aren't pooled.
+    static const size_t MaxObjectSize = 256;
+    static const size_t SlabSize = 64 * 1024;
+    // How many blocks move between a thread's free list and the shared one at a time.
+    static const size_t BatchSize = 32;
+
+    SlabPool(size_t objectSize, size_t alignment);
+
+    SlabPool(const SlabPool &) = delete;
+    SlabPool &operator=(const SlabPool &) = delete;
+
+    void *Allocate();
+    void Deallocate(void *ptr);
+
+    size_t GetBlockSize() const;
+    size_t GetSlabCount() const;
+
+    static bool CanPool(size_t objectSize, size_t alignment);
+
+  private:
+    struct Block
+    {
+      Block *m_Next;
+    };
+
+    // One thread's free blocks for one pool.
+    struct FreeList
+    {
+      SlabPool *m_Pool = nullptr;
+      Block *m_Head = nullptr;
+      size_t m_Count = 0;
+    };
+
+    struct ThreadCache;
+    struct ThreadCacheOwner;
+
+    FreeList *GetThreadFreeList();
+    void Refill(FreeList &list, size_t count);
+    void Release(FreeList &list, size_t count);
+
+    size_t m_BlockSize;
+    size_t m_Index;
+
+    // Everything below is shared between threads and only touched under the lock.
+    std::mutex m_Mutex;
+    Block *m_Free = nullptr;
+    char *m_SlabCurrent = nullptr;
+    char *m_SlabEnd = nullptr;
+    std::atomic<size_t> m_SlabCount{0};
+
+    static std::atomic<size_t> s_PoolCount;
+    static thread_local ThreadCache *s_ThreadCache;
+    static thread_local bool s_ThreadCacheDestroyed;
+    static thread_local ThreadCacheOwner s_ThreadCacheOwner;
+  };
+}
@@ -6,10 +6,17 @@ Author: Alex Troyer
 #include "TestAny.h"
 #include "Meta.h"
 #include "Any.h"
+#include "AnyVector.h"
+#include "Property.h"
+#include "Method.h"
+#include "AllocationCounter.h"
 #include <iostream>
 #include <chrono>
 #include <random>
 #include <limits>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 static std::default_random_engine s_Generator;
 
@@ -76,7 +83,8 @@ static void AnyAssignmentTest()
   }
   
   str = "Here's another one for a test...";
-  stringAny = std::move(str);
+  std::string movedStr = str;
+  stringAny = std::move(movedStr);
 
   // Test for reassignment
   if(stringAny.Get<std::string>() != str)
@@ -111,10 +119,629 @@ static void AnyAssignmentTest()
   std::cout << std::endl;
 }
 
+// Too big to fit inside of an Any.
+struct AnyLargeObject
+{
+  bool operator==(const AnyLargeObject &rhs) const { return std::equal(m_Values, m_Values + 8, rhs.m_Values); }
+
+  double m_Values[8];
+};
+
+CLASS_START(AnyLargeObject)
+CLASS_END;
+
+// An object that can be copied but not moved.
+struct AnyCopyOnlyObject
+{
+  AnyCopyOnlyObject() = default;
+  AnyCopyOnlyObject(const AnyCopyOnlyObject &) = default;
+  AnyCopyOnlyObject(AnyCopyOnlyObject &&) = delete;
+  AnyCopyOnlyObject &operator=(const AnyCopyOnlyObject &) = default;
+
+  double m_Values[8] = {};
+};
+
+CLASS_START(AnyCopyOnlyObject)
+CLASS_END;
+
+static void AnyAllocationTest()
+{
+  bool success = true;
+
+  std::cout << "Any Allocation Test" << std::endl
+            << "-------------" << std::endl;
+
+  size_t allocations = GetAllocationCount();
+
+  {
+    Any intAny = 5;
+    Any floatAny = 2.5f;
+    Any doubleAny = 7.25;
+
+    // Copies, moves and assignment between small types stay in the buffer too.
+    Any intCopy = intAny;
+    Any floatMove = std::move(floatAny);
+    doubleAny = 3.5;
+    intCopy = doubleAny;
+    floatMove = std::move(intAny);
+
+    Any defaultDouble(GET_META(double));
+
+    if(intCopy.Get<double>() != 3.5 || floatMove.Get<int>() != 5 || defaultDouble.Get<double>() != 0.0)
+    {
+      std::cout << "Small Values: Failed" << std::endl;
+      success = false;
+    }
+
+    if(!intCopy.IsInline() || !floatMove.IsInline() || !defaultDouble.IsInline())
+    {
+      std::cout << "Small Values Inline: Failed" << std::endl;
+      success = false;
+    }
+  }
+
+  // Test that int, float and double never allocate.
+  if(GetAllocationCount() != allocations)
+  {
+    std::cout << "No Allocations: Failed" << std::endl;
+    success = false;
+  }
+
+  AnyLargeObject large = {{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0}};
+
+  {
+    Any largeAny = large;
+    void *largeData = largeAny.GetInternal();
+    Any largeMove = std::move(largeAny);
+
+    // Large types still go on the heap (or their type's pool), and moving them just 
+    // takes the pointer.
+    if(largeMove.IsInline() || largeMove.GetInternal() != largeData || 
+       largeMove.Get<AnyLargeObject>().m_Values[7] != 8.0)
+    {
+      std::cout << "Large Values: Failed" << std::endl;
+      success = false;
+    }
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+// Counts how many times it gets copied.
+struct AnyCopyCounter
+{
+  AnyCopyCounter() = default;
+  AnyCopyCounter(size_t size) : m_Values(size, 1) {}
+  AnyCopyCounter(const AnyCopyCounter &rhs) : m_Values(rhs.m_Values) { ++s_Copies; }
+  AnyCopyCounter(AnyCopyCounter &&rhs) noexcept : m_Values(std::move(rhs.m_Values)) {}
+
+  AnyCopyCounter &operator=(const AnyCopyCounter &rhs) { m_Values = rhs.m_Values; ++s_Copies; return *this; }
+  AnyCopyCounter &operator=(AnyCopyCounter &&rhs) noexcept { m_Values = std::move(rhs.m_Values); return *this; }
+  bool operator==(const AnyCopyCounter &rhs) const { return m_Values == rhs.m_Values; }
+
+  std::vector<int> m_Values;
+  static int s_Copies;
+};
+
+int AnyCopyCounter::s_Copies = 0;
+
+CLASS_START(AnyCopyCounter)
+CLASS_END;
+
+// Hands out big values through a getter and a method.
+class AnyValueSource
+{
+public:
+  AnyCopyCounter GetCounter() const { return AnyCopyCounter(1000); }
+  std::string GetText() const { return std::string(1000, 'a'); }
+  AnyCopyCounter MakeCounter(int size) const { return AnyCopyCounter(size); }
+  AnyLargeObject GetLarge() const { return AnyLargeObject{{0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0}}; }
+  AnyLargeObject MakeLarge(double value) const { return AnyLargeObject{{value, value, value, value, value, value, value, value}}; }
+};
+
+CLASS_START(AnyValueSource)
+  PROPERTY("Counter", GetCounter);
+  PROPERTY("Text", GetText);
+  METHOD(MakeCounter);
+  PROPERTY("Large", GetLarge);
+  METHOD(MakeLarge);
+CLASS_END;
+
+static void AnyMoveTest()
+{
+  bool success = true;
+
+  std::cout << "Any Move Test" << std::endl
+            << "-------------" << std::endl;
+
+  AnyCopyCounter::s_Copies = 0;
+
+  // Temporaries are moved in when constructing and assigning.
+  Any counterAny = AnyCopyCounter(10);
+  counterAny = AnyCopyCounter(20);
+  counterAny = Any(AnyCopyCounter(30));
+
+  if(AnyCopyCounter::s_Copies != 0 || counterAny.Get<AnyCopyCounter>().m_Values.size() != 30)
+  {
+    std::cout << "Move Construction: Failed" << std::endl;
+    success = false;
+  }
+
+  // Named objects are still copied.
+  AnyCopyCounter counter(5);
+  Any copiedAny = counter;
+
+  if(AnyCopyCounter::s_Copies != 1 || counter.m_Values.size() != 5)
+  {
+    std::cout << "Copy Construction: Failed" << std::endl;
+    success = false;
+  }
+
+  // Emplace builds the object right in the Any.
+  AnyCopyCounter::s_Copies = 0;
+  Any emplaced;
+  emplaced.Emplace<AnyCopyCounter>(40);
+  std::string &text = emplaced.Emplace<std::string>(3, 'b');
+
+  if(AnyCopyCounter::s_Copies != 0 || text != "bbb" || !emplaced.Is<std::string>())
+  {
+    std::cout << "Emplace: Failed" << std::endl;
+    success = false;
+  }
+
+  // Values returned from getters and methods shouldn't be copied on their way into the Any.
+  AnyValueSource source;
+  Meta::Data *sourceMeta = GET_META(AnyValueSource);
+
+  Any fromGetter = sourceMeta->GetProperty("Counter")->Get(source);
+  Any fromMethod = sourceMeta->GetMethod("MakeCounter")->Call(source, 1000);
+
+  if(AnyCopyCounter::s_Copies != 0 || 
+     fromGetter.Get<AnyCopyCounter>().m_Values.size() != 1000 ||
+     fromMethod.Get<AnyCopyCounter>().m_Values.size() != 1000)
+  {
+    std::cout << "Getter and Method Return: Failed" << std::endl;
+    success = false;
+  }
+
+  // The only allocation for a string getter should be the one the getter makes.
+  size_t allocations = GetAllocationCount();
+  Any textAny = sourceMeta->GetProperty("Text")->Get(source);
+
+  if(GetAllocationCount() != allocations + 1 || textAny.Get<std::string>().size() != 1000)
+  {
+    std::cout << "String Getter Return: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+// Visitor that turns any of the basic types into a string.
+struct AnyToString
+{
+  template<typename T>
+  void operator()(const T &data) { m_Result = std::to_string(data); }
+  void operator()(const std::string &data) { m_Result = data; }
+
+  std::string m_Result;
+};
+
+static void AnyTypedAccessTest()
+{
+  bool success = true;
+
+  std::cout << "Any Typed Access Test" << std::endl
+            << "-------------" << std::endl;
+
+  Any intAny = 42;
+  Any empty;
+
+  // Test Is.
+  if(!intAny.Is<int>() || intAny.Is<float>() || intAny.Is<unsigned>() || empty.Is<int>())
+  {
+    std::cout << "Is: Failed" << std::endl;
+    success = false;
+  }
+
+  // Test TryGet.
+  int *intPtr = intAny.TryGet<int>();
+
+  if(intPtr == nullptr || *intPtr != 42 || intAny.TryGet<double>() != nullptr || 
+     empty.TryGet<int>() != nullptr)
+  {
+    std::cout << "TryGet: Failed" << std::endl;
+    success = false;
+  }
+
+  // References work the same way.
+  float value = 1.5f;
+  Any floatRef = Any::AnyRef(value);
+
+  if(floatRef.TryGet<float>() != &value || !floatRef.Is<float>())
+  {
+    std::cout << "TryGet Reference: Failed" << std::endl;
+    success = false;
+  }
+
+  AnyToString visitor;
+
+  // A reference to a const object only gives const access.
+  const int constValue = 7;
+  Any constRef = Any::AnyRef(constValue);
+
+  if(constRef.TryGet<int>() != nullptr || constRef.TryGet<const int>() != &constValue ||
+     !constRef.Visit(visitor) || visitor.m_Result != "7")
+  {
+    std::cout << "TryGet Const: Failed" << std::endl;
+    success = false;
+  }
+
+  // Test Visit on the basic types.
+  Any doubleAny = 0.5;
+  Any stringAny = std::string("text");
+
+  if(!intAny.Visit(visitor) || visitor.m_Result != "42" ||
+     !doubleAny.Visit(visitor) || visitor.m_Result != std::to_string(0.5) ||
+     !stringAny.Visit(visitor) || visitor.m_Result != "text")
+  {
+    std::cout << "Visit: Failed" << std::endl;
+    success = false;
+  }
+
+  // Visit doesn't call the visitor for types that aren't basic types.
+  Any large = AnyLargeObject();
+  bool called = false;
+
+  auto markCalled = [&called](const auto &) { called = true; };
+
+  if(large.Visit(markCalled) || empty.Visit(markCalled) || called)
+  {
+    std::cout << "Visit Other Types: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void AnyMemoryResourceTest()
+{
+  bool success = true;
+
+  std::cout << "Any Memory Resource Test" << std::endl
+            << "-------------" << std::endl;
+
+  alignas(std::max_align_t) char buffer[1024];
+  Meta::MonotonicResource arena(buffer, sizeof(buffer));
+
+  // Check if something was allocated out of the buffer.
+  auto inBuffer = [&buffer](const void *ptr)
+  {
+    return ptr >= buffer && ptr < buffer + sizeof(buffer);
+  };
+
+  // Build the type before counting, since a lazily registered type allocates then.
+  GET_META(AnyCopyOnlyObject);
+
+  size_t allocations = GetAllocationCount();
+
+  {
+    // Values that don't fit in the Any come from its resource.
+    Any large(&arena);
+    large = AnyLargeObject{{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0}};
+
+    if(!inBuffer(large.GetInternal()) || large.GetResource() != &arena || 
+       large.Get<AnyLargeObject>().m_Values[7] != 8.0)
+    {
+      std::cout << "Resource Assignment: Failed" << std::endl;
+      success = false;
+    }
+
+    // Default construction through the meta data.
+    Any constructed(GET_META(AnyLargeObject), &arena);
+
+    if(!inBuffer(constructed.GetInternal()))
+    {
+      std::cout << "Resource Construction: Failed" << std::endl;
+      success = false;
+    }
+
+    // Moving in data from somewhere else moves it into the resource.
+    Any outside = AnyLargeObject{{9.0}};
+    Any bound(&arena);
+    bound = std::move(outside);
+
+    if(!inBuffer(bound.GetInternal()) || bound.Get<AnyLargeObject>().m_Values[0] != 9.0)
+    {
+      std::cout << "Resource Move: Failed" << std::endl;
+      success = false;
+    }
+
+    // Data that can't be moved is copied into the resource instead, so the Any keeps
+    // the resource it was given once that data is gone.
+    alignas(std::max_align_t) char otherBuffer[256];
+    Meta::MonotonicResource otherArena(otherBuffer, sizeof(otherBuffer));
+
+    AnyCopyOnlyObject copyOnly;
+    copyOnly.m_Values[0] = 10.0;
+
+    Any outsideCopyOnly(&otherArena);
+    outsideCopyOnly = copyOnly;
+    Any boundCopyOnly(&arena);
+    boundCopyOnly = std::move(outsideCopyOnly);
+
+    bool copiedIn = inBuffer(boundCopyOnly.GetInternal()) && 
+                    boundCopyOnly.Get<AnyCopyOnlyObject>().m_Values[0] == 10.0;
+
+    boundCopyOnly = bound;
+
+    if(!copiedIn || !inBuffer(boundCopyOnly.GetInternal()) || boundCopyOnly.GetResource() != &arena)
+    {
+      std::cout << "Resource Copy Only Move: Failed" << std::endl;
+      success = false;
+    }
+
+    // The object info can construct into a resource too.
+    Meta::ObjectInfoBase *objectInfo = GET_META(AnyLargeObject)->GetObjectInfo();
+    void *object = objectInfo->CopyIn(&arena, large.GetInternal());
+
+    if(!inBuffer(object) || reinterpret_cast<AnyLargeObject *>(object)->m_Values[7] != 8.0)
+    {
+      std::cout << "ObjectInfo Resource: Failed" << std::endl;
+      success = false;
+    }
+
+    objectInfo->DestroyIn(&arena, object);
+  }
+
+  // Values from getters and methods go in the scoped resource.
+  AnyValueSource source;
+  Meta::Data *sourceMeta = GET_META(AnyValueSource);
+
+  {
+    Meta::ResourceScope scope(&arena);
+
+    Any fromGetter = sourceMeta->GetProperty("Large")->Get(source);
+    Any fromMethod = sourceMeta->GetMethod("MakeLarge")->Call(source, 3.0);
+
+    if(!inBuffer(fromGetter.GetInternal()) || fromGetter.Get<AnyLargeObject>().m_Values[7] != 7.0 ||
+       !inBuffer(fromMethod.GetInternal()) || fromMethod.Get<AnyLargeObject>().m_Values[7] != 3.0)
+    {
+      std::cout << "Scoped Resource: Failed" << std::endl;
+      success = false;
+    }
+  }
+
+  // Nothing here should have touched the global new, other than the argument list 
+  // for the method call.
+  if(GetAllocationCount() > allocations + 1 || arena.GetBlockCount() != 0)
+  {
+    std::cout << "Resource Allocations: Failed" << std::endl;
+    success = false;
+  }
+
+  // Outside of the scope things go back to normal.
+  Any afterScope = sourceMeta->GetProperty("Large")->Get(source);
+
+  if(inBuffer(afterScope.GetInternal()) || afterScope.GetResource() != nullptr)
+  {
+    std::cout << "Scope End: Failed" << std::endl;
+    success = false;
+  }
+
+  // An Any made outside of a scope only keeps the scoped resource while it holds the
+  // data allocated from it.
+  Any outlivesScope;
+
+  {
+    Meta::ResourceScope scope(&arena);
+    outlivesScope = AnyLargeObject{{1.0}};
+  }
+
+  bool scopedData = inBuffer(outlivesScope.GetInternal()) && outlivesScope.GetResource() == &arena;
+
+  // Assigning another Any releases the old data, so the copy is allocated normally.
+  Any replacement = AnyLargeObject{{2.0}};
+  outlivesScope = replacement;
+
+  if(!scopedData || inBuffer(outlivesScope.GetInternal()) || outlivesScope.GetResource() != nullptr ||
+     outlivesScope.Get<AnyLargeObject>().m_Values[0] != 2.0)
+  {
+    std::cout << "Scope Closed: Failed" << std::endl;
+    success = false;
+  }
+
+  arena.Release();
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+// Holds a runtime typed vector as a member and hands one out from a method.
+class AnyVectorHolder
+{
+public:
+  AnyVector m_Values = AnyVector(GET_META(int));
+
+  AnyVector MakeValues(int count) const
+  {
+    AnyVector values(GET_META(int));
+
+    for(int i = 0; i < count; ++i)
+    {
+      values.PushBack(i);
+    }
+
+    return values;
+  }
+};
+
+CLASS_START(AnyVectorHolder)
+  MEMBER(m_Values);
+  METHOD(MakeValues);
+CLASS_END;
+
+static void AnyVectorTest()
+{
+  bool success = true;
+
+  std::cout << "AnyVector Test" << std::endl
+            << "-------------" << std::endl;
+
+  // Plain data grows by relocating everything at once.
+  AnyVector ints(GET_META(int));
+
+  for(int i = 0; i < 100; ++i)
+  {
+    ints.PushBack(i);
+  }
+
+  int sum = 0;
+
+  for(Any element : ints)
+  {
+    sum += element.Get<int>();
+  }
+
+  if(ints.GetSize() != 100 || ints.GetCapacity() < 100 || sum != 4950 || 
+     ints.GetData<int>()[99] != 99 || ints.GetData<float>() != nullptr || ints.GetData<int *>() != nullptr ||
+     ints[50].GetInternal() != &ints.Get<int>(50))
+  {
+    std::cout << "Int Vector: Failed" << std::endl;
+    success = false;
+  }
+
+  // Growing back within the capacity reuses the memory that is already there.
+  size_t capacity = ints.GetCapacity();
+  int *data = ints.GetData<int>();
+
+  ints.Resize(10);
+  ints.Resize(capacity);
+
+  if(ints.GetSize() != capacity || ints.GetCapacity() != capacity || ints.GetData<int>() != data)
+  {
+    std::cout << "Resize Within Capacity: Failed" << std::endl;
+    success = false;
+  }
+
+  // Objects that own memory.  Adding an element of the vector to itself while it grows
+  // still copies the right thing.
+  AnyVector strings(GET_META(std::string));
+  strings.PushBack(std::string("A string long enough to be put on the heap"));
+
+  while(strings.GetSize() < strings.GetCapacity())
+  {
+    strings.EmplaceBack<std::string>(3, 'c');
+  }
+
+  strings.PushBack(strings[0]);
+
+  AnyVector stringCopy = strings;
+
+  if(strings.Get<std::string>(strings.GetSize() - 1) != strings.Get<std::string>(0) || 
+     stringCopy != strings)
+  {
+    std::cout << "String Vector: Failed" << std::endl;
+    success = false;
+  }
+
+  stringCopy.PopBack();
+  stringCopy.Resize(20);
+
+  if(stringCopy == strings || stringCopy.GetSize() != 20 || !stringCopy.Get<std::string>(19).empty())
+  {
+    std::cout << "Pop and Resize: Failed" << std::endl;
+    success = false;
+  }
+
+  AnyVector moved = std::move(stringCopy);
+  moved.Clear();
+
+  if(!moved.IsEmpty() || !stringCopy.IsEmpty() || moved.GetMeta() != GET_META(std::string))
+  {
+    std::cout << "Move and Clear: Failed" << std::endl;
+    success = false;
+  }
+
+  // Growing moves the elements instead of copying them.
+  AnyCopyCounter::s_Copies = 0;
+  AnyVector counters(GET_META(AnyCopyCounter));
+
+  for(size_t i = 0; i < 50; ++i)
+  {
+    counters.EmplaceBack<AnyCopyCounter>(i);
+  }
+
+  if(AnyCopyCounter::s_Copies != 0 || counters.Get<AnyCopyCounter>(49).m_Values.size() != 49)
+  {
+    std::cout << "Growth Moves: Failed" << std::endl;
+    success = false;
+  }
+
+  // Reflection can get at a vector through a property or a method and go through 
+  // its elements without boxing each one.
+  AnyVectorHolder holder;
+  holder.m_Values.PushBack(5);
+  holder.m_Values.PushBack(6);
+
+  Meta::Data *holderMeta = GET_META(AnyVectorHolder);
+  Any fromProperty = holderMeta->GetProperty("m_Values")->Get(holder);
+  Any fromMethod = holderMeta->GetMethod("MakeValues")->Call(holder, 10);
+
+  sum = 0;
+
+  for(Any element : fromProperty.Get<AnyVector>())
+  {
+    sum += element.Get<int>();
+  }
+
+  for(Any element : fromMethod.Get<AnyVector>())
+  {
+    sum += element.Get<int>();
+  }
+
+  if(sum != 56 || fromMethod.Get<AnyVector>().GetSize() != 10)
+  {
+    std::cout << "Property and Method: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
 void TestAny()
 {
   time_t time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
   s_Generator.seed(static_cast<unsigned>(time));
 
   AnyAssignmentTest();
+  AnyAllocationTest();
+  AnyMoveTest();
+  AnyTypedAccessTest();
+  AnyMemoryResourceTest();
+  AnyVectorTest();
 }
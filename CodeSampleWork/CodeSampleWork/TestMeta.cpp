@@ -0,0 +1,629 @@
+/*****************************************************************************
+File:   TestMeta.cpp
+Author: Alex Troyer
+  Tests the meta data registry to make sure it works correctly.
+*****************************************************************************/
+#include "TestMeta.h"
+#include "Meta.h"
+#include "Property.h"
+#include "Method.h"
+#include "Diff.h"
+#include "Hash.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+// A small hierarchy to test inherited lookups with.
+class MetaTestBase
+{
+public:
+  int Value() const { return 1; }
+  int BaseOnly() const { return 2; }
+
+  int m_Base = 3;
+  int m_Hidden = 4;
+};
+
+class MetaTestDerived : public MetaTestBase
+{
+public:
+  int m_Derived = 5;
+};
+
+class MetaTestMostDerived : public MetaTestDerived
+{
+public:
+  int Value() const { return 6; }
+
+  int m_Hidden = 7;
+};
+
+// Registered child first to make sure parenting doesn't depend on registration order.
+CLASS_START(MetaTestMostDerived)
+  PARENT(MetaTestDerived);
+  METHOD(Value);
+  MEMBER(m_Hidden);
+CLASS_END;
+
+CLASS_START(MetaTestDerived)
+  PARENT(MetaTestBase);
+  MEMBER(m_Derived);
+CLASS_END;
+
+CLASS_START(MetaTestBase)
+  METHOD(Value);
+  METHOD(BaseOnly);
+  MEMBER(m_Base);
+  MEMBER(m_Hidden);
+CLASS_END;
+
+// Classes only touched by the lazy registration test, one found by type and one by name.
+class MetaTestLazy : public MetaTestBase
+{
+public:
+  int m_Lazy = 8;
+};
+
+class MetaTestLazyNamed : public MetaTestLazy
+{
+};
+
+CLASS_START(MetaTestLazy)
+  PARENT(MetaTestBase);
+  MEMBER(m_Lazy);
+CLASS_END;
+
+CLASS_START(MetaTestLazyNamed)
+  PARENT(MetaTestLazy);
+CLASS_END;
+
+// A class with a run of plain members, members that have to be compared by value, a
+// computed property, and a static member, to test whole object diffs with.
+class MetaTestDiff
+{
+public:
+  int GetSum() const { return m_First + m_Second + m_Third; }
+
+  int m_First = 1;
+  int m_Second = 2;
+  int m_Third = 3;
+  float m_Float = 0.0f;
+  std::string m_Text = "Text";
+
+  static int s_Static;
+};
+
+int MetaTestDiff::s_Static = 0;
+
+CLASS_START(MetaTestDiff)
+  MEMBER(m_First);
+  MEMBER(m_Second);
+  MEMBER(m_Third);
+  MEMBER(m_Float);
+  MEMBER(m_Text);
+  PROPERTY("Sum", GetSum);
+  MEMBER(s_Static);
+CLASS_END;
+
+// A class that is hashed from its serialized properties.  The cache isn't serialized,
+// so it isn't part of the hash or ==.
+class MetaTestHash
+{
+public:
+  bool operator==(const MetaTestHash &rhs) const
+  {
+    return m_First == rhs.m_First && m_Second == rhs.m_Second && m_Float == rhs.m_Float && 
+           m_Text == rhs.m_Text;
+  }
+
+  int m_First = 1;
+  int m_Second = 2;
+  float m_Float = 0.0f;
+  std::string m_Text = "Text";
+  int m_Cache = 0;
+};
+
+CLASS_START(MetaTestHash)
+  MEMBER(m_First).EnableSerialization();
+  MEMBER(m_Second).EnableSerialization();
+  MEMBER(m_Float).EnableSerialization();
+  MEMBER(m_Text).EnableSerialization();
+  MEMBER(m_Cache);
+CLASS_END;
+
+static void TypeIdTest()
+{
+  // Verify that every registered type has a unique id that finds its record.
+
+  bool success = true;
+
+  std::cout << "Meta Test: Type Ids" << std::endl
+            << "-------------" << std::endl;
+
+  if(GET_META(int)->GetId() == GET_META(float)->GetId())
+  {
+    std::cout << "Unique Ids: Failed" << std::endl;
+    success = false;
+  }
+
+  if(Meta::TypeTable::Get(GET_META_ID(std::string)) != GET_META(std::string))
+  {
+    std::cout << "Table Lookup: Failed" << std::endl;
+    success = false;
+  }
+
+  // Every id handed out should be dense and map back to a record with that id.
+  for(Meta::TypeId id = 0; id < Meta::TypeTable::GetCount(); ++id)
+  {
+    if(Meta::TypeTable::Get(id)->GetId() != id)
+    {
+      std::cout << "Dense Ids: Failed" << std::endl;
+      success = false;
+      break;
+    }
+  }
+
+  if(Meta::TypeTable::Get(Meta::TypeTable::GetCount()) != nullptr)
+  {
+    std::cout << "Out Of Range Id: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+// META_NAME hashes a literal at compile time.
+static_assert(META_NAME("int").GetHash() == Meta::HashString("int", 3), "META_NAME didn't hash at compile time!");
+
+// GET_META_NAME is an expression, so it can be used outside of a function.  Whether int
+// is registered yet depends on static initialization order, so this might be null.
+static Meta::Data *s_NamedBeforeMain = GET_META_NAME(META_NAME("int"));
+
+static void NameLookupTest()
+{
+  // Verify that looking up meta data by name works for every kind of name.
+
+  bool success = true;
+
+  std::cout << "Meta Test: Name Lookup" << std::endl
+            << "-------------" << std::endl;
+
+  if(GET_META_NAME("int") != GET_META(int) || GET_META_NAME(META_NAME("int")) != GET_META(int) ||
+     (s_NamedBeforeMain != nullptr && s_NamedBeforeMain != GET_META(int)))
+  {
+    std::cout << "Literal: Failed" << std::endl;
+    success = false;
+  }
+
+  // A temporary string lives until the lookup is done.
+  if(GET_META_NAME(std::string("str") + "ing") != GET_META(std::string))
+  {
+    std::cout << "Temporary std::string: Failed" << std::endl;
+    success = false;
+  }
+
+  std::string name = "string";
+
+  if(GET_META_NAME(name) != GET_META(std::string))
+  {
+    std::cout << "std::string: Failed" << std::endl;
+    success = false;
+  }
+
+  const char *cName = "double";
+
+  if(GET_META_NAME(cName) != GET_META(double))
+  {
+    std::cout << "const char *: Failed" << std::endl;
+    success = false;
+  }
+
+  // The compile time and runtime hashes have to agree for any of this to work.
+  if(META_NAME("ObjectInfoTestNoDelete").GetHash() != Meta::HashedName(std::string("ObjectInfoTestNoDelete")).GetHash() ||
+     META_NAME("int").GetHash() != Meta::HashedName("int").GetHash())
+  {
+    std::cout << "Hash: Failed" << std::endl;
+    success = false;
+  }
+
+  if(GET_META_NAME("NotARegisteredType") != nullptr)
+  {
+    std::cout << "Missing Name: Failed" << std::endl;
+    success = false;
+  }
+
+  // Interning the same characters twice should give the same Name.
+  if(Meta::Name(Meta::HashedName("u_int")) != GET_META(unsigned)->GetInternedName())
+  {
+    std::cout << "Interning: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void InheritanceTest()
+{
+  // Verify that properties and methods are found through the parents, and that the
+  // ones on a child hide the ones on its parents.
+
+  bool success = true;
+
+  std::cout << "Meta Test: Inherited Lookups" << std::endl
+            << "-------------" << std::endl;
+
+  MetaTestMostDerived test;
+  Meta::Data *meta = GET_META_VAR(test);
+
+  if(!meta->IsFrozen())
+  {
+    std::cout << "Frozen: Failed" << std::endl;
+    success = false;
+  }
+
+  if(meta->GetParent() != GET_META(MetaTestDerived) || 
+     GET_META(MetaTestDerived)->GetParent() != GET_META(MetaTestBase))
+  {
+    std::cout << "Parents: Failed" << std::endl;
+    success = false;
+  }
+
+  if(meta->GetProperty("m_Base")->Get(test).Get<int>() != test.m_Base ||
+     meta->GetProperty("m_Derived")->Get(test).Get<int>() != test.m_Derived)
+  {
+    std::cout << "Inherited Property: Failed" << std::endl;
+    success = false;
+  }
+
+  if(meta->GetProperty("m_Hidden")->Get(test).Get<int>() != test.m_Hidden)
+  {
+    std::cout << "Hidden Property: Failed" << std::endl;
+    success = false;
+  }
+
+  if(meta->GetMethod("BaseOnly")->Call(test).Get<int>() != test.BaseOnly())
+  {
+    std::cout << "Inherited Method: Failed" << std::endl;
+    success = false;
+  }
+
+  if(meta->GetMethod("Value")->Call(test).Get<int>() != test.Value())
+  {
+    std::cout << "Hidden Method: Failed" << std::endl;
+    success = false;
+  }
+
+  if(meta->GetProperty("NotAProperty") != nullptr || meta->GetMethod("NotAMethod") != nullptr)
+  {
+    std::cout << "Missing Name: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void LazyRegistrationTest()
+{
+  // Verify that types are built by the time they're found by type or by name, with
+  // their parent and inherited properties.  With lazy registration on, also verify
+  // they weren't built until then.
+
+  bool success = true;
+
+  std::cout << "Meta Test: Lazy Registration" << std::endl
+            << "-------------" << std::endl;
+
+  Meta::Data *lazyRecord = Meta::DataStorage<MetaTestLazy>::PeekData();
+  Meta::Data *namedRecord = Meta::DataStorage<MetaTestLazyNamed>::PeekData();
+
+#if META_LAZY_REGISTRATION
+  if(lazyRecord->IsBuilt() || namedRecord->IsBuilt() || lazyRecord->GetParent() != nullptr)
+  {
+    std::cout << "Not Built Yet: Failed" << std::endl;
+    success = false;
+  }
+#endif
+
+  Meta::Data *lazy = GET_META(MetaTestLazy);
+
+  if(lazy != lazyRecord || !lazy->IsBuilt() || !lazy->IsFrozen() ||
+     lazy->GetParent() != GET_META(MetaTestBase) || !lazy->IsA(GET_META(MetaTestBase)) ||
+     lazy->GetProperty("m_Lazy") == nullptr || lazy->GetProperty("m_Base") == nullptr)
+  {
+    std::cout << "GET_META: Failed" << std::endl;
+    success = false;
+  }
+
+  Meta::Data *named = GET_META_NAME("MetaTestLazyNamed");
+
+  if(named != namedRecord || !named->IsBuilt() || !named->IsFrozen() || 
+     named->GetParent() != lazy || !named->IsA(GET_META(MetaTestBase)) ||
+     named->GetDepth() != 2 || named->GetProperty("m_Lazy") == nullptr)
+  {
+    std::cout << "GET_META_NAME: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void IsATest()
+{
+  // Verify the derived from checks and the checked downcast.
+
+  bool success = true;
+
+  std::cout << "Meta Test: IsA and Cast" << std::endl
+            << "-------------" << std::endl;
+
+  Meta::Data *base = GET_META(MetaTestBase);
+  Meta::Data *derived = GET_META(MetaTestDerived);
+  Meta::Data *mostDerived = GET_META(MetaTestMostDerived);
+
+  if(base->GetDepth() != 0 || derived->GetDepth() != 1 || mostDerived->GetDepth() != 2)
+  {
+    std::cout << "Depth: Failed" << std::endl;
+    success = false;
+  }
+
+  if(!mostDerived->IsA(base) || !mostDerived->IsA(derived) || !mostDerived->IsA(mostDerived))
+  {
+    std::cout << "IsA Ancestor: Failed" << std::endl;
+    success = false;
+  }
+
+  if(base->IsA(derived) || mostDerived->IsA(GET_META(int)) || GET_META(int)->IsA(base))
+  {
+    std::cout << "IsA Unrelated: Failed" << std::endl;
+    success = false;
+  }
+
+  if(!mostDerived->HasParent(base) || mostDerived->HasParent(mostDerived))
+  {
+    std::cout << "HasParent: Failed" << std::endl;
+    success = false;
+  }
+
+  MetaTestMostDerived test;
+  void *object = &test;
+
+  if(Meta::Cast<MetaTestBase>(mostDerived, object) != static_cast<MetaTestBase *>(&test) ||
+     Meta::Cast<MetaTestMostDerived>(base, object) != nullptr)
+  {
+    std::cout << "Cast: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+// Only registered at runtime, like a type from a plugin.
+class MetaTestRuntime : public MetaTestBase
+{
+};
+
+static void RuntimeRegistrationTest()
+{
+  // Verify that a type registered on another thread after the registry is frozen
+  // is published frozen and can be found by name.
+
+  bool success = true;
+
+  std::cout << "Meta Test: Runtime Registration" << std::endl
+            << "-------------" << std::endl;
+
+  if(GET_META_NAME("MetaTestRuntime") != nullptr)
+  {
+    std::cout << "Not Published Yet: Failed" << std::endl;
+    success = false;
+  }
+
+  std::thread plugin([]()
+  {
+    Meta::RegistryWriteLock lock;
+    Meta::DataStorage<MetaTestRuntime>::SetData("MetaTestRuntime", sizeof(MetaTestRuntime),
+                                                Meta::ArenaNew<Meta::ObjectInfo<MetaTestRuntime>>());
+    GET_META(MetaTestRuntime)->AddParent(GET_META(MetaTestBase));
+    Meta::DataStorage<MetaTestRuntime>::Publish();
+  });
+
+  plugin.join();
+
+  Meta::Data *data = GET_META_NAME("MetaTestRuntime");
+
+  if(data != GET_META(MetaTestRuntime) || !data->IsFrozen())
+  {
+    std::cout << "Published: Failed" << std::endl;
+    success = false;
+  }
+
+  if(!data->IsA(GET_META(MetaTestBase)) || data->GetProperty("m_Base") == nullptr)
+  {
+    std::cout << "Inherited: Failed" << std::endl;
+    success = false;
+  }
+
+  // Everything registered before is still there after the snapshot was swapped.
+  if(GET_META_NAME("MetaTestBase") != GET_META(MetaTestBase))
+  {
+    std::cout << "Old Names: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void DiffTest()
+{
+  // Verify that diffing two objects sets the bit of exactly the properties that differ.
+
+  Meta::Data *meta = GET_META(MetaTestDiff);
+  MetaTestDiff lhs;
+  MetaTestDiff rhs;
+
+  bool success = true;
+
+  std::cout << "Meta Test: Diff" << std::endl
+            << "-------------" << std::endl;
+
+  // The three ints are next to each other, so they should share one span.
+  const Meta::PropertySpanVector &spans = meta->GetPropertySpans();
+
+  if(spans.size() != 4 || spans[0].m_Count != 3 || spans[0].m_Size != 3 * sizeof(int))
+  {
+    std::cout << "Spans: Failed" << std::endl;
+    success = false;
+  }
+
+  Meta::PropertyMask mask = Meta::Diff(lhs, rhs);
+
+  if(mask.GetCount() != meta->GetOrderedData().size() || !mask.IsEmpty())
+  {
+    std::cout << "Same: Failed" << std::endl;
+    success = false;
+  }
+
+  // Changing a member in the run only sets its own bit, and a computed property that
+  // depends on it is different too.
+  rhs.m_Second = 20;
+  rhs.m_Text = "Other";
+  Meta::Diff(meta, &lhs, &rhs, mask);
+
+  if(mask.GetSetCount() != 3 || !mask.Test(1) || !mask.Test(4) || !mask.Test(5) || 
+     mask.Test(0) || mask.Test(2))
+  {
+    std::cout << "Different: Failed" << std::endl;
+    success = false;
+  }
+
+  // Floats are compared by value, so 0 and -0 are the same even though their bytes aren't.
+  rhs = lhs;
+  rhs.m_Float = -0.0f;
+
+  if(!Meta::Diff(lhs, rhs).IsEmpty())
+  {
+    std::cout << "Float: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void HashTest()
+{
+  // Verify that objects are hashed from their serialized properties, so equal objects
+  // hash the same and can be used as keys.
+
+  MetaTestHash lhs;
+  MetaTestHash rhs;
+
+  bool success = true;
+
+  std::cout << "Meta Test: Hash" << std::endl
+            << "-------------" << std::endl;
+
+  // Only the serialized ints are hashed as bytes, the float and string hash their values.
+  if(GET_META(MetaTestHash)->GetSerializedPropertySpans().size() != 3)
+  {
+    std::cout << "Spans: Failed" << std::endl;
+    success = false;
+  }
+
+  // Members that aren't serialized don't change the hash, and neither does -0.
+  rhs.m_Cache = 10;
+  rhs.m_Float = -0.0f;
+
+  if(Meta::Hash(lhs) != Meta::Hash(rhs))
+  {
+    std::cout << "Equal: Failed" << std::endl;
+    success = false;
+  }
+
+  rhs.m_Second = 3;
+
+  if(Meta::Hash(lhs) == Meta::Hash(rhs))
+  {
+    std::cout << "Different: Failed" << std::endl;
+    success = false;
+  }
+
+  std::unordered_set<MetaTestHash, Meta::ReflectedHash<MetaTestHash>> set;
+  set.insert(lhs);
+
+  if(set.count(lhs) != 1 || set.count(rhs) != 0)
+  {
+    std::cout << "Hashed Container: Failed" << std::endl;
+    success = false;
+  }
+
+  // Anys hash with the type's std::hash if it has one, otherwise through its meta data.
+  std::unordered_map<Any, int> map;
+  map[Any(5)] = 1;
+  map[Any(std::string("Five"))] = 2;
+  map[Any(lhs)] = 3;
+
+  if(Any(5).Hash() != std::hash<int>()(5) || Any(lhs).Hash() != Meta::Hash(lhs) ||
+     map[Any(5)] != 1 || map[Any(std::string("Five"))] != 2 || map[Any(lhs)] != 3 || 
+     map.count(Any(rhs)) != 0 || map.count(Any(5u)) != 0)
+  {
+    std::cout << "Any Keys: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+void TestMeta()
+{
+  // Runs first so nothing else has touched its types yet.
+  LazyRegistrationTest();
+  TypeIdTest();
+  NameLookupTest();
+  InheritanceTest();
+  IsATest();
+  RuntimeRegistrationTest();
+  DiffTest();
+  HashTest();
+}
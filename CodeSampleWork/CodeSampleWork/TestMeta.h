@@ -0,0 +1,8 @@
+/*****************************************************************************
+File:   TestMeta.h
+Author: Alex Troyer
+  Tests the meta data registry to make sure it works correctly.
+*****************************************************************************/
+#pragma once
+
+void TestMeta();
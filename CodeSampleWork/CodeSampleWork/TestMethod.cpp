@@ -5,7 +5,9 @@ Author: Alex Troyer
 *****************************************************************************/
 #include "TestMethod.h"
 #include "Method.h"
+#include "MethodHandle.h"
 #include "Meta.h"
+#include "AllocationCounter.h"
 #include <iostream>
 
 // A class to test with.
@@ -35,6 +37,9 @@ public:
   static int StaticOverload(float, int) {return 3;}
   static int StaticOverload(int, float) {return 4;};
   static int StaticOverload(float) {return 5;}
+
+  int NoArgs() const {return 6;}
+  int ManyArgs(int a, int b, int c, int d, int e, int f, int g) const {return a + b + c + d + e + f + g;}
 };
 
 CLASS_START(TestClass)
@@ -67,6 +72,10 @@ CLASS_START(TestClass)
                           int (*)(int, float),
                           int (*)(float));
 
+  // Methods to call with no arguments and a lot of them.
+  METHOD(NoArgs);
+  METHOD(ManyArgs);
+
 CLASS_END;
 
 static void CallingMethods()
@@ -299,6 +308,172 @@ static void OverloadedMethodStatic()
   std::cout << std::endl;
 }
 
+static void OverloadedMethodFind()
+{
+  // Verify that overloads are found by the types of their arguments, and that nothing
+  // is found for arguments no overload takes.
+
+  bool success = true;
+  std::cout << "Overloaded Method Test: Find" << std::endl
+    << "-------------" << std::endl;
+
+  Meta::Data *data = GET_META(TestClass);
+  Meta::MethodOverloads *sameArgCount = data->GetMethod("SameArgCount");
+  Meta::MethodOverloads *constAndNonConst = data->GetMethod("ConstAndNonConst");
+
+  // Every overload finds itself, even with more overloads than the first table holds.
+  for(Meta::Method *method : sameArgCount->GetMethods())
+  {
+    if(sameArgCount->FindMethod(method->GetArguments(), false) != method)
+    {
+      std::cout << "Every Overload: Failed" << std::endl;
+      success = false;
+      break;
+    }
+  }
+
+  if(sameArgCount->FindMethod({GET_META(float), GET_META(float)}, false) != nullptr ||
+     sameArgCount->FindMethod({GET_META(int)}, false) != nullptr ||
+     sameArgCount->FindMethod({GET_META(int), GET_META(int), GET_META(int)}, false) != nullptr)
+  {
+    std::cout << "No Overload: Failed" << std::endl;
+    success = false;
+  }
+
+  // A const object only finds the const overload, a non-const object prefers the other.
+  Meta::Method *constMethod = constAndNonConst->FindMethod({GET_META(int)}, true);
+  Meta::Method *nonConstMethod = constAndNonConst->FindMethod({GET_META(int)}, false);
+
+  if(constMethod == nullptr || !constMethod->IsConst() || 
+     nonConstMethod == nullptr || nonConstMethod->IsConst() ||
+     data->GetMethod("Something")->FindMethod({GET_META(int)}, true) != nullptr ||
+     data->GetMethod("SomethingConst")->FindMethod({GET_META(int)}, false) == nullptr)
+  {
+    std::cout << "Const: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void CallingMethodsAllocations()
+{
+  // Verify that calling through a method or its overloads doesn't allocate, since the
+  // arguments are passed in an array on the stack.
+
+  bool success = true;
+  std::cout << "Method Test: Allocations" << std::endl
+    << "-------------" << std::endl;
+
+  TestClass test;
+  Meta::Data *data = GET_META(TestClass);
+  Meta::MethodOverloads *noArgs = data->GetMethod("NoArgs");
+  Meta::MethodOverloads *manyArgs = data->GetMethod("ManyArgs");
+  Meta::MethodOverloads *differentArgCount = data->GetMethod("DifferentArgCount");
+  Meta::MethodOverloads *staticOverload = data->GetMethod("StaticOverload");
+  Meta::Method *manyArgsMethod = manyArgs->GetMethods().front();
+
+  size_t allocations = GetAllocationCount();
+
+  int noArgsResult = noArgs->Call(test).Get<int>();
+  int manyArgsResult = manyArgs->Call(test, 1, 2, 3, 4, 5, 6, 7).Get<int>();
+  int methodResult = manyArgsMethod->Call(test, 1, 1, 1, 1, 1, 1, 1).Get<int>();
+  int overloadResult = differentArgCount->Call(test, 1, 1, 1).Get<int>();
+  int staticResult = staticOverload->CallStatic(1.0f, 1).Get<int>();
+
+  if(GetAllocationCount() != allocations)
+  {
+    std::cout << "No Allocations: Failed" << std::endl;
+    success = false;
+  }
+
+  if(noArgsResult != test.NoArgs() || manyArgsResult != test.ManyArgs(1, 2, 3, 4, 5, 6, 7) ||
+     methodResult != 7 || overloadResult != test.DifferentArgCount(1, 1, 1) ||
+     staticResult != TestClass::StaticOverload(1.0f, 1))
+  {
+    std::cout << "Results: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void MethodHandles()
+{
+  // Verify that handles bind to the overload with exactly their signature, call it
+  // directly, and don't bind to anything else.
+
+  bool success = true;
+  std::cout << "Method Handle Test" << std::endl
+    << "-------------" << std::endl;
+
+  TestClass test;
+  const TestClass cTest;
+  Meta::Data *data = GET_META(TestClass);
+
+  Meta::MethodHandle<int(TestClass &, int)> something("Something");
+  Meta::MethodHandle<int(TestClass &, int)> somethingConst("SomethingConst");
+  Meta::MethodHandle<int(const TestClass &, int)> constSomethingConst("SomethingConst");
+  Meta::MethodHandle<int(TestClass &, int, float)> sameArgCount("SameArgCount");
+  Meta::MethodHandle<int(TestClass &, int, int, int, int, int, int, int)> manyArgs("ManyArgs");
+  Meta::StaticMethodHandle<int(float, int)> staticOverload(data->GetMethod("StaticOverload"));
+
+  if(!something.IsValid() || something.Call(test, 47) != test.Something(47) ||
+     !somethingConst.IsValid() || somethingConst.Call(test, 1) != test.SomethingConst(1) ||
+     !constSomethingConst.IsValid() || constSomethingConst.Call(cTest, 1) != cTest.SomethingConst(1) ||
+     !sameArgCount.IsValid() || sameArgCount.Call(test, 5, 5.0f) != test.SameArgCount(5, 5.0f) ||
+     !manyArgs.IsValid() || manyArgs.Call(test, 1, 2, 3, 4, 5, 6, 7) != test.ManyArgs(1, 2, 3, 4, 5, 6, 7) ||
+     !staticOverload.IsValid() || staticOverload.Call(1.0f, 1) != TestClass::StaticOverload(1.0f, 1))
+  {
+    std::cout << "Call: Failed" << std::endl;
+    success = false;
+  }
+
+  // Like the overloads, a non-const object prefers the non-const method.
+  Meta::MethodHandle<int(TestClass &, int)> nonConstOverload("ConstAndNonConst");
+  Meta::MethodHandle<int(const TestClass &, int)> constOverload("ConstAndNonConst");
+
+  if(nonConstOverload.Call(test, 5) != test.ConstAndNonConst(5) ||
+     constOverload.Call(cTest, 5) != cTest.ConstAndNonConst(5))
+  {
+    std::cout << "Const: Failed" << std::endl;
+    success = false;
+  }
+
+  // The arguments, return, const-ness and static-ness all have to match.
+  Meta::MethodHandle<int(TestClass &, double)> wrongArgs("Something");
+  Meta::MethodHandle<float(TestClass &, int)> wrongReturn("Something");
+  Meta::MethodHandle<int(TestClass &, const int &)> wrongReference("Something");
+  Meta::MethodHandle<int(const TestClass &, int)> wrongConst("Something");
+  Meta::MethodHandle<int(TestClass &, int)> wrongStatic("StaticFunc");
+  Meta::StaticMethodHandle<int(int)> wrongNonStatic(data->GetMethod("Something"));
+  Meta::MethodHandle<int(TestClass &, int)> missing("NotAMethod");
+
+  if(wrongArgs.IsValid() || wrongReturn.IsValid() || wrongReference.IsValid() || wrongConst.IsValid() ||
+     wrongStatic.IsValid() || wrongNonStatic.IsValid() || missing.IsValid())
+  {
+    std::cout << "Wrong Signature: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
 void TestMethod()
 {
   CallingMethods();
@@ -306,4 +481,7 @@ void TestMethod()
   OverloadedMethodDifferentArgCount();
   OverloadedMethodDifferentConst();
   OverloadedMethodStatic();
+  OverloadedMethodFind();
+  CallingMethodsAllocations();
+  MethodHandles();
 }
\ No newline at end of file
@@ -1,6 +1,12 @@
 #include "TestObjectInfo.h"
 #include "Meta.h"
+#include "AllocationCounter.h"
 #include <iostream>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <thread>
+#include <vector>
 
 // A class with all generated constructors and destructor.
 class ObjectInfoTestNoDelete
@@ -37,6 +43,50 @@ private:
   ~ObjectInfoTestPrivate(){};
 };
 
+// A class small enough to be pooled.
+class ObjectInfoTestPooled
+{
+public:
+  double m_Values[4] = {1.0, 2.0, 3.0, 4.0};
+};
+
+// A class too big to be pooled.
+class ObjectInfoTestUnpooled
+{
+public:
+  char m_Data[Meta::SlabPool::MaxObjectSize + 1];
+};
+
+// A small parent class whose children get destroyed through it.
+class ObjectInfoTestParent
+{
+public:
+  virtual ~ObjectInfoTestParent() {};
+};
+
+class ObjectInfoTestChild : public ObjectInfoTestParent
+{
+public:
+  ~ObjectInfoTestChild()
+  {
+    ++s_Destroyed;
+  }
+
+  static int s_Destroyed;
+  std::string m_Text = "A string long enough to be put on the heap";
+};
+
+int ObjectInfoTestChild::s_Destroyed = 0;
+
+CLASS_START(ObjectInfoTestPooled)
+CLASS_END;
+
+CLASS_START(ObjectInfoTestParent)
+CLASS_END;
+
+CLASS_START(ObjectInfoTestUnpooled)
+CLASS_END;
+
 CLASS_START(ObjectInfoTestNoDelete)
 CLASS_END;
 
@@ -238,10 +288,285 @@ static void TestPrivate()
   std::cout << std::endl;
 }
 
+static void TestSlabPool()
+{
+  // Small types get their memory from a pool that reuses freed blocks.
+
+  bool success = true;
+
+  std::cout
+    << "ObjectInfo Test: Slab Pool" << std::endl
+    << "-------------" << std::endl;
+
+  Meta::ObjectInfoBase *pooled = GET_META(ObjectInfoTestPooled)->GetObjectInfo();
+  Meta::ObjectInfoBase *unpooled = GET_META(ObjectInfoTestUnpooled)->GetObjectInfo();
+
+  if((pooled->GetPool() != nullptr) != (META_SLAB_POOLS != 0) || unpooled->GetPool() != nullptr)
+  {
+    std::cout << "Pool Selection: Failed" << std::endl;
+    success = false;
+  }
+
+  // Test that the object is built in the pooled memory.
+  void *ptr = pooled->Construct();
+
+  if(reinterpret_cast<ObjectInfoTestPooled *>(ptr)->m_Values[3] != 4.0)
+  {
+    std::cout << "Pooled Construct: Failed" << std::endl;
+    success = false;
+  }
+
+  pooled->Destroy(ptr);
+
+  // Polymorphic types aren't pooled, so a child made with new can be destroyed 
+  // through its parent.
+  Meta::ObjectInfoBase *parent = GET_META(ObjectInfoTestParent)->GetObjectInfo();
+  parent->Destroy(static_cast<ObjectInfoTestParent *>(new ObjectInfoTestChild));
+
+  if(parent->GetPool() != nullptr || ObjectInfoTestChild::s_Destroyed != 1)
+  {
+    std::cout << "Destroy Through Parent: Failed" << std::endl;
+    success = false;
+  }
+
+  if(pooled->GetPool() != nullptr)
+  {
+    // The block just freed is the next one handed out on this thread, and nothing
+    // touches the global new.
+    size_t allocations = GetAllocationCount();
+    void *reused = pooled->Construct();
+
+    if(reused != ptr || GetAllocationCount() != allocations)
+    {
+      std::cout << "Pooled Reuse: Failed" << std::endl;
+      success = false;
+    }
+
+    pooled->Destroy(reused);
+
+    // Allocate on some threads and free everything on this one, which has to hand 
+    // blocks back to the shared list as its free list grows.
+    const size_t threadCount = 4;
+    const size_t objectCount = 1000;
+    std::vector<void *> objects[threadCount];
+    std::vector<std::thread> threads;
+
+    for(size_t i = 0; i < threadCount; ++i)
+    {
+      threads.emplace_back([pooled, &objects, i]()
+      {
+        for(size_t j = 0; j < objectCount; ++j)
+        {
+          objects[i].push_back(pooled->Construct());
+        }
+      });
+    }
+
+    for(std::thread &thread : threads)
+    {
+      thread.join();
+    }
+
+    for(std::vector<void *> &threadObjects : objects)
+    {
+      for(void *object : threadObjects)
+      {
+        if(reinterpret_cast<ObjectInfoTestPooled *>(object)->m_Values[0] != 1.0)
+          success = false;
+
+        pooled->Destroy(object);
+      }
+    }
+
+    if(!success)
+    {
+      std::cout << "Pooled Threads: Failed" << std::endl;
+    }
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void TestBatched()
+{
+  // Arrays of objects can be built, copied, moved and destroyed with one call.
+
+  bool success = true;
+
+  std::cout
+    << "ObjectInfo Test: Batched Lifetime" << std::endl
+    << "-------------" << std::endl;
+
+  Meta::ObjectInfoBase *intInfo = GET_META(int)->GetObjectInfo();
+  Meta::ObjectInfoBase *stringInfo = GET_META(std::string)->GetObjectInfo();
+  Meta::ObjectInfoBase *publicInfo = GET_META(ObjectInfoTestPublic)->GetObjectInfo();
+
+  if(!intInfo->IsTriviallyCopyable() || !intInfo->IsTriviallyDestructible() || !intInfo->IsTriviallyRelocatable() ||
+     stringInfo->IsTriviallyCopyable() || stringInfo->IsTriviallyDestructible() || 
+     publicInfo->IsTriviallyCopyable() || publicInfo->IsTriviallyDestructible())
+  {
+    std::cout << "Trivial Traits: Failed" << std::endl;
+    success = false;
+  }
+
+  // Plain data.
+  const size_t count = 8;
+  int ints[count] = {0, 1, 2, 3, 4, 5, 6, 7};
+  int intCopies[count] = {};
+
+  intInfo->CopyN(intCopies, ints, count);
+
+  if(std::memcmp(ints, intCopies, sizeof(ints)) != 0)
+  {
+    std::cout << "Trivial Copy: Failed" << std::endl;
+    success = false;
+  }
+
+  // Slide everything over by two, which overlaps.
+  intInfo->RelocateN(ints + 2, ints, count - 2);
+
+  if(ints[2] != 0 || ints[7] != 5)
+  {
+    std::cout << "Trivial Relocate: Failed" << std::endl;
+    success = false;
+  }
+
+  // Objects that own memory.
+  typedef std::aligned_storage<sizeof(std::string), alignof(std::string)>::type StringStorage;
+  StringStorage first[count];
+  StringStorage second[count];
+  std::string *strings = reinterpret_cast<std::string *>(first);
+  std::string *copies = reinterpret_cast<std::string *>(second);
+
+  stringInfo->ConstructN(strings, count);
+
+  for(size_t i = 0; i < count; ++i)
+  {
+    if(!strings[i].empty())
+      success = false;
+
+    strings[i] = "A string long enough to be put on the heap " + std::to_string(i);
+  }
+
+  stringInfo->CopyN(copies, strings, count);
+
+  for(size_t i = 0; i < count; ++i)
+  {
+    if(copies[i] != strings[i])
+      success = false;
+  }
+
+  stringInfo->DestroyN(strings, count);
+  stringInfo->MoveN(strings, copies, count);
+
+  if(strings[count - 1] != "A string long enough to be put on the heap 7")
+    success = false;
+
+  stringInfo->DestroyN(copies, count);
+
+  // Slide the strings back by one, then forward by one, which overlap both ways.
+  // The first string is destroyed so it isn't leaked when relocated over.
+  stringInfo->DestroyN(strings, 1);
+  stringInfo->RelocateN(strings, strings + 1, count - 1);
+  stringInfo->RelocateN(strings + 1, strings, count - 1);
+
+  if(strings[1] != "A string long enough to be put on the heap 1" || 
+     strings[count - 1] != "A string long enough to be put on the heap 7")
+    success = false;
+
+  // The first slot was relocated away, so only the rest are still alive.
+  stringInfo->DestroyN(strings + 1, count - 1);
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+  else
+  {
+    std::cout << "Batched Objects: Failed" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void TestLifetimeTable()
+{
+  // Each type's Data has a table of function pointers matching its object info.
+
+  bool success = true;
+
+  std::cout
+    << "ObjectInfo Test: Lifetime Table" << std::endl
+    << "-------------" << std::endl;
+
+  const Meta::LifetimeTable &intLifetime = GET_META(int)->GetLifetime();
+  const Meta::LifetimeTable &stringLifetime = GET_META(std::string)->GetLifetime();
+  const Meta::LifetimeTable &deletedLifetime = GET_META(ObjectInfoTestDelete)->GetLifetime();
+  const Meta::LifetimeTable &pooledLifetime = GET_META(ObjectInfoTestPooled)->GetLifetime();
+
+  if(intLifetime.m_Size != sizeof(int) || intLifetime.m_Alignment != alignof(int) ||
+     !intLifetime.Has(Meta::LifetimeTable::IsTriviallyCopyable | Meta::LifetimeTable::IsTriviallyRelocatable) ||
+     intLifetime.m_Destroy != nullptr || stringLifetime.m_Destroy == nullptr || 
+     stringLifetime.Has(Meta::LifetimeTable::IsTriviallyCopyable))
+  {
+    std::cout << "Table Contents: Failed" << std::endl;
+    success = false;
+  }
+
+  if(deletedLifetime.m_Construct != nullptr || deletedLifetime.m_Copy != nullptr || 
+     deletedLifetime.m_Move != nullptr || deletedLifetime.m_Destroy != nullptr ||
+     deletedLifetime.Has(Meta::LifetimeTable::HasDestructor))
+  {
+    std::cout << "Deleted Functions: Failed" << std::endl;
+    success = false;
+  }
+
+  if(pooledLifetime.m_Pool != GET_META(ObjectInfoTestPooled)->GetObjectInfo()->GetPool())
+  {
+    std::cout << "Table Pool: Failed" << std::endl;
+    success = false;
+  }
+
+  // The table sits in a single cache line.
+  if(reinterpret_cast<std::uintptr_t>(&intLifetime) % Meta::CacheLineSize != 0 ||
+     reinterpret_cast<std::uintptr_t>(&pooledLifetime) % Meta::CacheLineSize != 0)
+  {
+    std::cout << "Table Alignment: Failed" << std::endl;
+    success = false;
+  }
+
+  // Build and tear down a string through the table.
+  std::string source = "A string long enough to be put on the heap";
+  void *copy = stringLifetime.CopyIn(nullptr, &source);
+
+  if(*reinterpret_cast<std::string *>(copy) != source)
+  {
+    std::cout << "Table Copy: Failed" << std::endl;
+    success = false;
+  }
+
+  stringLifetime.DestroyIn(nullptr, copy);
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
 void TestObjectInfo()
 {
   TestNotDeleted();
   TestDeleted();
   TestPublic();
   TestPrivate();
+  TestSlabPool();
+  TestBatched();
+  TestLifetimeTable();
 }
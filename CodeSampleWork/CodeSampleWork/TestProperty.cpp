@@ -7,7 +7,10 @@ Author: Alex Troyer
 #include "Meta.h"
 #include "Any.h"
 #include "Property.h"
+#include "PropertyHandle.h"
+#include "AllocationCounter.h"
 #include <iostream>
+#include <string>
 
 class PropertyTest
 {
@@ -43,6 +46,7 @@ public:
   }
 
   int m_Member = 234;
+  std::string m_Text = "Text";
   const int m_Constant = 42;
   static int m_StaticValue;
   static const int m_ConstantStaticValue = 34985745;
@@ -64,12 +68,13 @@ CLASS_START(PropertyTest)
   PROPERTY("Static", GetStaticValue, SetStaticValue);
   PROPERTY("StaticGet", GetStaticValueGet);
   MEMBER(m_Member);
+  MEMBER(m_Text);
   MEMBER(m_StaticValue);
   MEMBER(m_Constant);
   MEMBER(m_ConstantStaticValue);
 CLASS_END;
 
-void TestProperty()
+static void PropertyGetSetTest()
 {
   // Verify that getting and setting the different properties work.
 
@@ -135,6 +140,27 @@ void TestProperty()
     success = false;
   }
 
+  Meta::Property *member = meta->GetProperty("m_Member");
+  size_t memberOffset = reinterpret_cast<char *>(&test.m_Member) - reinterpret_cast<char *>(&test);
+
+  if(!member->HasOffset() || member->GetOffset() != memberOffset ||
+     member->GetValueSize() != sizeof(int) || !member->IsTriviallyCopyable() ||
+     meta->GetProperty("Value")->HasOffset())
+  {
+    std::cout << "Member Offset: Failed" << std::endl;
+    success = false;
+  }
+
+  meta->GetProperty("m_Text")->Set(test, std::string("A string too long for the small string buffer"));
+
+  if(meta->GetProperty("m_Text")->Get(test).Get<std::string>() != test.m_Text ||
+     test.m_Text != "A string too long for the small string buffer" ||
+     meta->GetProperty("m_Text")->IsTriviallyCopyable())
+  {
+    std::cout << "Get/Set String Member: Failed" << std::endl;
+    success = false;
+  }
+
   if(meta->GetProperty("m_StaticValue")->Get().Get<int>() != test.m_StaticValue)
   {
     std::cout << "Get Static Member: Failed" << std::endl;
@@ -155,6 +181,14 @@ void TestProperty()
     success = false;
   }
 
+  meta->GetProperty("m_Constant")->Set(test, 7);
+
+  if(test.m_Constant != 42)
+  {
+    std::cout << "Set Constant Member: Failed" << std::endl;
+    success = false;
+  }
+
   if(meta->GetProperty("m_ConstantStaticValue")->Get().Get<int>() != test.m_ConstantStaticValue)
   {
     std::cout << "Get Const Static Member: Failed" << std::endl;
@@ -168,3 +202,277 @@ void TestProperty()
 
   std::cout << std::endl;
 }
+
+// A class that gets properties from its parent.
+class PropertyHandleChild : public PropertyTest
+{
+public:
+  float m_Scale = 1.5f;
+};
+
+CLASS_START(PropertyHandleChild)
+  PARENT(PropertyTest);
+  MEMBER(m_Scale);
+CLASS_END;
+
+static void PropertyHandleTest()
+{
+  // Handles read and write properties as their own type once they are bound.
+
+  PropertyHandleChild test;
+  Meta::Data *meta = GET_META(PropertyTest);
+
+  bool success = true;
+
+  std::cout << "Property Handle Test" << std::endl
+            << "-------------" << std::endl;
+
+  // Members go straight through the offset.
+  Meta::PropertyHandle<PropertyTest, int> member("m_Member");
+  Meta::PropertyHandle<PropertyTest, std::string> text("m_Text");
+
+  member.Set(test, 99);
+  text.Set(test, "Handle");
+
+  if(!member.IsValid() || member.Get(test) != 99 || test.m_Member != 99 || 
+     text.Get(test) != "Handle" || test.m_Text != "Handle")
+  {
+    std::cout << "Member Handle: Failed" << std::endl;
+    success = false;
+  }
+
+  // Properties with a get and set call them without an Any.
+  Meta::PropertyHandle<PropertyTest, int> value("Value");
+  value.Set(test, 1234);
+
+  if(!value.IsValid() || value.Get(test) != 1234 || test.GetValue() != 1234)
+  {
+    std::cout << "Get/Set Handle: Failed" << std::endl;
+    success = false;
+  }
+
+  // Read only properties can be read but not written.
+  Meta::PropertyHandle<PropertyTest, int> constant("m_Constant");
+  Meta::PropertyHandle<PropertyTest, int> onlyGet("OnlyGet");
+  constant.Set(test, 7);
+  onlyGet.Set(test, 7);
+
+  if(constant.Get(test) != 42 || test.m_Constant != 42 || onlyGet.Get(test) != 42)
+  {
+    std::cout << "Read Only Handle: Failed" << std::endl;
+    success = false;
+  }
+
+  // A child class can use its parent's properties, and a handle without the class
+  // works on any object.
+  Meta::PropertyHandle<PropertyHandleChild, int> inherited("m_Member");
+  Meta::PropertyHandle<PropertyHandleChild, float> scale("m_Scale");
+  Meta::PropertyValueHandle<float> anyScale(GET_META(PropertyHandleChild)->GetProperty("m_Scale"));
+
+  if(inherited.Get(test) != 99 || scale.Get(test) != 1.5f || anyScale.Get(&test) != 1.5f)
+  {
+    std::cout << "Inherited Handle: Failed" << std::endl;
+    success = false;
+  }
+
+  // Binding checks the types.
+  Meta::PropertyHandle<PropertyTest, float> wrongValue("m_Member");
+  Meta::PropertyHandle<PropertyTest, float> wrongClass(GET_META(PropertyHandleChild)->GetProperty("m_Scale"));
+  Meta::PropertyHandle<PropertyTest, int> staticMember(meta->GetProperty("m_StaticValue"));
+  Meta::PropertyHandle<PropertyTest, int> missing("NotAProperty");
+
+  if(wrongValue.IsValid() || wrongClass.IsValid() || staticMember.IsValid() || missing.IsValid())
+  {
+    std::cout << "Handle Type Check: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void PropertyRefTest()
+{
+  // Member properties can be looked at in place instead of copied.
+
+  PropertyTest test;
+  const PropertyTest &constTest = test;
+  Meta::Data *meta = GET_META(PropertyTest);
+
+  bool success = true;
+
+  std::cout << "Property Reference Test" << std::endl
+            << "-------------" << std::endl;
+
+  test.m_Text = "A string long enough to be put on the heap";
+
+  size_t allocations = GetAllocationCount();
+  Any text = meta->GetProperty("m_Text")->GetRef(test);
+
+  if(GetAllocationCount() != allocations || text.GetInternal() != &test.m_Text || 
+     !text.HoldsReference() || text.IsConst())
+  {
+    std::cout << "Member Reference: Failed" << std::endl;
+    success = false;
+  }
+
+  // Writing through the reference changes the member.
+  text = std::string("Changed");
+
+  if(test.m_Text != "Changed")
+  {
+    std::cout << "Write Through Reference: Failed" << std::endl;
+    success = false;
+  }
+
+  // A const object or a const member gives a const reference, which can't be written
+  // through.
+  Any constText = meta->GetProperty("m_Text")->GetRef(constTest);
+  Any constant = meta->GetProperty("m_Constant")->GetRef(test);
+
+  constText = std::string("Not Written");
+
+  if(!constant.IsConst() || constant.Get<int>() != 42 || 
+     test.m_Text != "Changed" || constText.HoldsReference())
+  {
+    std::cout << "Const Reference: Failed" << std::endl;
+    success = false;
+  }
+
+  // Getters compute their value, so they still give a copy.
+  Any value = meta->GetProperty("Value")->GetRef(test);
+
+  if(value.HoldsReference() || value.Get<int>() != test.GetValue())
+  {
+    std::cout << "Getter Value: Failed" << std::endl;
+    success = false;
+  }
+
+  // References to const objects are const.
+  Any constAny = Any::AnyRef(constTest.m_Constant);
+
+  if(!constAny.IsConst() || !constAny.HoldsReference())
+  {
+    std::cout << "Const AnyRef: Failed" << std::endl;
+    success = false;
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+static void PropertyGatherTest()
+{
+  // A property can be read out of or written into a whole array of objects at once.
+
+  const size_t count = 8;
+  PropertyTest tests[count];
+  int members[count];
+  int values[count];
+  std::string texts[count];
+  Meta::Data *meta = GET_META(PropertyTest);
+
+  bool success = true;
+
+  std::cout << "Property Gather Test" << std::endl
+            << "-------------" << std::endl;
+
+  for(size_t i = 0; i < count; ++i)
+  {
+    tests[i].m_Member = static_cast<int>(i) * 3;
+    tests[i].m_Text = std::to_string(i);
+    tests[i].SetValue(static_cast<int>(i) + 100);
+  }
+
+  meta->GetProperty("m_Member")->Gather(tests, count, members);
+  meta->GetProperty("Value")->Gather(tests, count, values);
+  meta->GetProperty("m_Text")->Gather(tests, count, texts);
+
+  for(size_t i = 0; i < count; ++i)
+  {
+    if(members[i] != tests[i].m_Member || values[i] != tests[i].GetValue() || texts[i] != tests[i].m_Text)
+    {
+      std::cout << "Gather: Failed" << std::endl;
+      success = false;
+      break;
+    }
+  }
+
+  // Writing goes through the setter for computed properties, and never writes const members.
+  for(size_t i = 0; i < count; ++i)
+  {
+    members[i] = -static_cast<int>(i);
+    values[i] = static_cast<int>(i) * 7;
+  }
+
+  meta->GetProperty("m_Member")->Scatter(tests, count, members);
+  meta->GetProperty("Value")->Scatter(tests, count, values);
+  meta->GetProperty("m_Constant")->Scatter(tests, count, members);
+
+  for(size_t i = 0; i < count; ++i)
+  {
+    if(tests[i].m_Member != members[i] || tests[i].GetValue() != values[i] || tests[i].m_Constant != 42)
+    {
+      std::cout << "Scatter: Failed" << std::endl;
+      success = false;
+      break;
+    }
+  }
+
+  // Objects don't have to be next to each other, as long as they are the same distance apart.
+  meta->GetProperty("m_Member")->Gather(&tests[1], 2 * sizeof(PropertyTest), count / 2, members);
+
+  for(size_t i = 0; i < count / 2; ++i)
+  {
+    if(members[i] != tests[1 + 2 * i].m_Member)
+    {
+      std::cout << "Stride: Failed" << std::endl;
+      success = false;
+      break;
+    }
+  }
+
+  // A child class can use the properties of its parent.
+  PropertyHandleChild children[count];
+
+  for(size_t i = 0; i < count; ++i)
+  {
+    members[i] = static_cast<int>(i) * 3;
+  }
+
+  meta->GetProperty("m_Member")->Scatter(children, count, members);
+  meta->GetProperty("m_Member")->Gather(children, count, values);
+
+  for(size_t i = 0; i < count; ++i)
+  {
+    if(children[i].m_Member != members[i] || values[i] != members[i])
+    {
+      std::cout << "Child Class: Failed" << std::endl;
+      success = false;
+      break;
+    }
+  }
+
+  if(success)
+  {
+    std::cout << "Success" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+void TestProperty()
+{
+  PropertyGetSetTest();
+  PropertyHandleTest();
+  PropertyRefTest();
+  PropertyGatherTest();
+}